@@ -0,0 +1,121 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#ifndef VIDEO_DETECT_INCLUDE_VIDEO_DETECT_DIVISOR_VOTES_H_
+#define VIDEO_DETECT_INCLUDE_VIDEO_DETECT_DIVISOR_VOTES_H_
+
+#include <vector>
+
+namespace video_detect {
+
+/**
+ * The DivisorVotes class counts how often the positions of corners along one
+ * dimension of a frame (its height or its width) divide that dimension into
+ * a whole amount of tiles. A position votes for the amount of tiles if the
+ * first decimal of the division is zero, the full dimension never receives a
+ * vote and neither do amounts above a maximum. The first vote for an amount
+ * of tiles counts as 1, every following vote adds the amount itself.
+ *
+ * The amount of tiles of every position is looked up in a table, which is
+ * only calculated when the dimension changes. The votes are held in a
+ * histogram indexed by the amount of tiles, so voting does not allocate.
+ *
+ * The modulo sums of all amounts are updated when an amount receives its first
+ * vote, which happens at most once per amount. Finding the best amount is then
+ * a single pass over the amounts.
+ *
+ * The votes of two objects can be merged, which gives the same votes as one
+ * object receiving the votes of both. Merging is thus associative and the
+ * order of the votes does not matter.
+ */
+class DivisorVotes {
+ public:
+  /**
+   * @brief Construct a new DivisorVotes object
+   *
+   * @param max_divisor the maximum amount of tiles, at least 1
+   */
+  explicit DivisorVotes(int max_divisor);
+
+  /**
+   * @brief Set the size of the dimension the positions are voted in. The votes
+   * are kept, as an amount of tiles does not depend on the size.
+   *
+   * @param size the height or width of the frame, at least 1
+   */
+  void SetSize(int size);
+
+  /**
+   * @brief Get the size of the dimension, 0 before it has been set
+   */
+  int GetSize() const { return size_; }
+
+  /**
+   * @brief Add the votes of another object, as if all of its votes had been
+   * voted here. The size is taken from the other object if it was not set.
+   *
+   * @param other the votes to add, with the same maximum amount of tiles
+   */
+  void Merge(const DivisorVotes &other);
+
+  /**
+   * @brief Vote with the position of a corner
+   *
+   * @param position the position along the dimension, in [0, size)
+   */
+  void Vote(int position) {
+    const int kDivisor = divisors_[position];
+    if (kDivisor == 0) {
+      return;
+    }
+    if (votes_[kDivisor] == 0) {
+      AddCandidate(kDivisor);
+    }
+    votes_[kDivisor] += votes_[kDivisor] != 0 ? kDivisor : 1;
+  }
+
+  /**
+   * @brief Get the votes for an amount of tiles
+   *
+   * @param divisor the amount of tiles
+   * @return int the votes, 0 if it never received any
+   */
+  int GetVotes(int divisor) const {
+    return divisor > 0 && divisor <= max_divisor_ ? votes_[divisor] : 0;
+  }
+
+  /**
+   * @brief Get the sum of the remainders of dividing an amount of tiles by
+   * every voted amount of tiles. Amounts that divide well have a low sum.
+   *
+   * @param divisor the amount of tiles, in [1, max_divisor]
+   */
+  int GetModuloSum(int divisor) const { return modulo_sums_[divisor]; }
+
+  /**
+   * @brief Get the voted amount of tiles with the lowest modulo sum per vote,
+   * the smallest amount wins a tie
+   *
+   * @return int the amount of tiles, 0 if nothing has been voted yet
+   */
+  int GetBestDivisor() const;
+
+  /**
+   * @brief Get the amounts of tiles which received votes, in ascending order
+   */
+  std::vector<int> GetCandidates() const;
+
+ private:
+  const int max_divisor_;
+  int size_ = 0;
+  std::vector<int> divisors_;     // the amount of tiles of every position
+  std::vector<int> votes_;        // the votes of every amount, 0 is unused
+  std::vector<int> modulo_sums_;  // the modulo sum of every amount
+
+  void AddCandidate(int divisor);
+};
+
+}  // namespace video_detect
+
+#endif  // VIDEO_DETECT_INCLUDE_VIDEO_DETECT_DIVISOR_VOTES_H_
@@ -0,0 +1,50 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#ifndef VIDEO_DETECT_INCLUDE_VIDEO_DETECT_ESTIMATOR_H_
+#define VIDEO_DETECT_INCLUDE_VIDEO_DETECT_ESTIMATOR_H_
+
+#include <cstdint>
+#include <utility>
+
+#include "video-detect/mat/mat_2d.h"
+#include "video-detect/util/object_receiver.h"
+
+namespace video_detect {
+
+/**
+ * The Estimator class is the interface of the engines which receive grayscale
+ * frames and estimate the size of the individual frames in the video grid
+ */
+class Estimator : public util::ObjectReceiver<const mat::Mat2D<uint8_t> &> {
+ public:
+  /**
+   * @brief Get the Best Estimate Frame Size for the input video
+   *
+   * @return std::pair<int, int> the best estimate frame size as
+   *                             a pair [width, height]
+   */
+  virtual std::pair<int, int> GetBestEstimateFrameSize() = 0;
+
+  /**
+   * @brief Check if a best estimate has been found
+   *
+   * @return true if a best estimate has been found
+   * @return false if a best estimate has not been found
+   */
+  virtual bool HasBestEstimate() const = 0;
+
+  /**
+   * @brief Merge the votes of another estimator of the same engine into this
+   * one and update the best estimate, as if this estimator had received the
+   * frames of both. This allows splitting a video over several estimators.
+   *
+   * @param other the estimator to merge, which must be of the same engine
+   */
+  virtual void Merge(const Estimator &other) = 0;
+};
+
+}  // namespace video_detect
+
+#endif  // VIDEO_DETECT_INCLUDE_VIDEO_DETECT_ESTIMATOR_H_
@@ -0,0 +1,36 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#ifndef VIDEO_DETECT_INCLUDE_VIDEO_DETECT_FFMPEG_DECODER_SETTINGS_H_
+#define VIDEO_DETECT_INCLUDE_VIDEO_DETECT_FFMPEG_DECODER_SETTINGS_H_
+
+#include "video-detect/ffmpeg/frame_skip.h"
+
+namespace video_detect {
+namespace ffmpeg {
+
+/**
+ * The ways the decoder may spread the decoding over its threads
+ */
+enum class DecodeThreading {
+  kFrameAndSlice,  // let the codec pick, frames are preferred over slices
+  kFrame,          // decode several frames at once, adds a frame of delay per
+                   // thread
+  kSlice           // decode the slices of one frame at once, if the video has
+                   // several slices per frame
+};
+
+/**
+ * The settings the video decoder is opened with
+ */
+struct DecoderSettings {
+  FrameSkip frame_skip = FrameSkip::kNone;
+  int thread_count = 0;  // 0 uses one thread per hardware thread
+  DecodeThreading threading = DecodeThreading::kFrameAndSlice;
+};
+
+}  // namespace ffmpeg
+}  // namespace video_detect
+
+#endif  // VIDEO_DETECT_INCLUDE_VIDEO_DETECT_FFMPEG_DECODER_SETTINGS_H_
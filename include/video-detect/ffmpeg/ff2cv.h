@@ -9,8 +9,11 @@
 #ifndef VIDEO_DETECT_INCLUDE_VIDEO_DETECT_FFMPEG_FF2CV_H_
 #define VIDEO_DETECT_INCLUDE_VIDEO_DETECT_FFMPEG_FF2CV_H_
 
-#include <opencv2/core/mat.hpp>
+#include <cstdint>
+#include <vector>
 
+#include "video-detect/ffmpeg/decoder_settings.h"
+#include "video-detect/mat/mat_2d.h"
 #include "video-detect/util/object_receiver.h"
 
 namespace video_detect {
@@ -18,19 +21,92 @@ namespace ffmpeg {
 
 /**
  * This code is adapted from the referenced GIST to load each frame from a video
- * using FFMPEG into a OpenCV image.
+ * using FFMPEG into a grayscale image. For YUV videos the grayscale image is
+ * the luma plane of the decoded frame, which is passed on without copying.
  *
- * Each frame is passed on to the video_detect ObjectReceiver
+ * Each frame is passed on to the video_detect ObjectReceiver. Frames limited by
+ * the frame count are decoded, but not converted. The decoding throughput is
+ * printed once the video has been read.
  *
  * @param video_path            is the full path to the video file
  * @param modulo_frame_count    the frame count is modulo'd by this to prevent
  *                              limit the amount of frames to process by the
  *                              receiver
+ * @param decoder_settings      the decoder threading and the frames it
+ *                              discards, these are not counted by the frame
+ *                              count
  * @param receiver              each non-limited frame is passed on to the
  *                              receiver
  */
 int ff2cv(const char *video_file, int modulo_frame_count,
-          video_detect::util::ObjectReceiver<const cv::Mat&> *receiver);
+          const DecoderSettings &decoder_settings,
+          video_detect::util::ObjectReceiver<mat::Mat2D<uint8_t>> *receiver);
+
+/**
+ * Read one of several equally long time segments of a video like ff2cv reads
+ * the whole video, so that the segments can be read in parallel. The input is
+ * opened separately for every segment and seeked to the keyframe preceding
+ * the segment. Frames before the segment are decoded but not passed on, the
+ * first frame after the segment ends the decoding. A frame without a
+ * timestamp belongs to the segment of the frame before it, so a later segment
+ * only passes such frames on after its first frame. Every frame thus belongs
+ * to exactly one segment, and on a stream without any timestamps all frames
+ * belong to the first segment.
+ *
+ * @param video_path            is the full path to the video file
+ * @param modulo_frame_count    the frame count of the segment is modulo'd by
+ *                              this to limit the amount of frames to process
+ *                              by the receiver
+ * @param segment               the index of the segment, in [0, segment_count)
+ * @param segment_count         the amount of segments of the video
+ * @param decoder_settings      the decoder threading and the frames it
+ *                              discards
+ * @param receiver              each non-limited frame of the segment is passed
+ *                              on to the receiver
+ */
+int ff2cv_segment(
+    const char *video_file, int modulo_frame_count, int segment,
+    int segment_count, const DecoderSettings &decoder_settings,
+    video_detect::util::ObjectReceiver<mat::Mat2D<uint8_t>> *receiver);
+
+/**
+ * Sample frames at timestamps spread over the video instead of decoding all
+ * of them. For each timestamp the input is seeked to the preceding keyframe
+ * and decoded up to the first frame at or after the timestamp, which is
+ * passed on as a grayscale image like ff2cv does. The decoding time thus
+ * depends on the amount of samples rather than on the length of the video.
+ *
+ * @param video_path            is the full path to the video file
+ * @param sample_interval       the seconds between two samples, or 0
+ * @param sample_count          the amount of samples spread evenly over the
+ *                              video, or 0
+ * @param decoder_settings      the decoder threading and the frames it
+ *                              discards, a discarded frame is never sampled
+ * @param receiver              each sampled frame is passed on to the receiver
+ */
+int ff2cv_sampled(
+    const char *video_file, double sample_interval, int sample_count,
+    const DecoderSettings &decoder_settings,
+    video_detect::util::ObjectReceiver<mat::Mat2D<uint8_t>> *receiver);
+
+/**
+ * Get the timestamps ff2cv_sampled samples, in the time base of the video
+ * stream. The sample count places each sample in the middle of one of the
+ * equally long parts of the video, the sample interval places a sample every
+ * interval starting at the first frame.
+ *
+ * @param start                 the timestamp of the first frame
+ * @param length                the length of the video, 0 if it is unknown
+ * @param time_base             the seconds of one unit of the time base
+ * @param sample_interval       the seconds between two samples, or 0
+ * @param sample_count          the amount of evenly spaced samples, or 0
+ * @return std::vector<int64_t> the increasing timestamps, empty if the length
+ *                              is unknown
+ */
+std::vector<int64_t> GetSampleTimestamps(int64_t start, int64_t length,
+                                         double time_base,
+                                         double sample_interval,
+                                         int sample_count);
 
 }  // namespace ffmpeg
 }  // namespace video_detect
@@ -0,0 +1,37 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#ifndef VIDEO_DETECT_INCLUDE_VIDEO_DETECT_FFMPEG_FRAME_PLANE_ADAPTER_H_
+#define VIDEO_DETECT_INCLUDE_VIDEO_DETECT_FFMPEG_FRAME_PLANE_ADAPTER_H_
+
+#include <cstdint>
+
+#include "video-detect/mat/mat_2d_view.h"
+
+struct AVFrame;
+
+namespace video_detect {
+namespace ffmpeg {
+
+/**
+ * @brief The FramePlaneAdapter adapts one 8-bit plane of a decoded AVFrame to
+ * a read-only Mat2DView without copying any values. The frame must outlive the
+ * view. Planes of formats with more than 8 bits per component, or planes that
+ * do not exist, result in an empty view.
+ */
+class FramePlaneAdapter : public mat::Mat2DView<const uint8_t> {
+ public:
+  /**
+   * @brief Construct a new Frame Plane Adapter object
+   *
+   * @param frame the decoded frame
+   * @param plane the plane index, for YUV formats plane 0 is the luma plane
+   */
+  explicit FramePlaneAdapter(const AVFrame *frame, int plane = 0);
+};
+
+}  // namespace ffmpeg
+}  // namespace video_detect
+
+#endif  // VIDEO_DETECT_INCLUDE_VIDEO_DETECT_FFMPEG_FRAME_PLANE_ADAPTER_H_
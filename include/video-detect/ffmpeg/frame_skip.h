@@ -0,0 +1,24 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#ifndef VIDEO_DETECT_INCLUDE_VIDEO_DETECT_FFMPEG_FRAME_SKIP_H_
+#define VIDEO_DETECT_INCLUDE_VIDEO_DETECT_FFMPEG_FRAME_SKIP_H_
+
+namespace video_detect {
+namespace ffmpeg {
+
+/**
+ * The frames the decoder discards without decoding them. Discarded frames are
+ * never passed on, thus the frame modulo only counts the decoded frames.
+ */
+enum class FrameSkip {
+  kNone,          // decode all frames
+  kNonReference,  // discard the frames no other frame is predicted from
+  kNonKey         // decode only the keyframes
+};
+
+}  // namespace ffmpeg
+}  // namespace video_detect
+
+#endif  // VIDEO_DETECT_INCLUDE_VIDEO_DETECT_FFMPEG_FRAME_SKIP_H_
@@ -0,0 +1,77 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#ifndef VIDEO_DETECT_INCLUDE_VIDEO_DETECT_FFMPEG_LUMA_CONVERTER_H_
+#define VIDEO_DETECT_INCLUDE_VIDEO_DETECT_FFMPEG_LUMA_CONVERTER_H_
+
+#include <cstdint>
+
+#include "video-detect/mat/mat_2d.h"
+
+struct AVFrame;
+struct SwsContext;
+
+namespace video_detect {
+namespace ffmpeg {
+
+/**
+ * @brief The LumaConverter converts decoded AVFrames to grayscale matrices.
+ *
+ * All matrices are full range gray of [0, 255], the range the thresholds of
+ * the estimators are tuned on. For full range YUV and gray formats with an
+ * 8-bit luma plane the luma plane already is the grayscale image. The matrix
+ * then wraps that plane without copying any values and holds a reference to
+ * the frame buffer, so the decoder does not reuse it for as long as the matrix
+ * is alive. Such a matrix must be treated as read-only. Limited range luma of
+ * [16, 235] is expanded through a lookup table into an owned matrix. All other
+ * formats are converted to gray with sws_scale into an owned matrix, the
+ * scaler context is reused across frames.
+ */
+class LumaConverter {
+ public:
+  LumaConverter() = default;
+  LumaConverter(const LumaConverter &) = delete;
+  LumaConverter &operator=(const LumaConverter &) = delete;
+  ~LumaConverter();
+
+  /**
+   * @brief Convert a decoded frame to a grayscale matrix
+   *
+   * @param frame the decoded frame
+   * @return mat::Mat2D<uint8_t> the grayscale image, empty if the frame could
+   * not be converted
+   */
+  mat::Mat2D<uint8_t> Convert(const AVFrame *frame);
+
+  /**
+   * @brief Check whether frames of a pixel format are wrapped without copying
+   *
+   * @param format the AVPixelFormat of the frames
+   * @return true if plane 0 holds one 8-bit luma value per pixel
+   */
+  static bool HasLumaPlane(int format);
+
+  /**
+   * @brief Check whether the values of a frame are full range
+   *
+   * @param frame the decoded frame
+   * @return true if its color range is full, or unspecified for a gray or
+   * YUVJ format
+   */
+  static bool IsFullRange(const AVFrame *frame);
+
+ private:
+  SwsContext *sws_context_ = nullptr;
+
+  /**
+   * Set the range of the source frame and the full range of the gray result
+   * on the scaler context
+   */
+  void SetRange(const AVFrame *frame);
+};
+
+}  // namespace ffmpeg
+}  // namespace video_detect
+
+#endif  // VIDEO_DETECT_INCLUDE_VIDEO_DETECT_FFMPEG_LUMA_CONVERTER_H_
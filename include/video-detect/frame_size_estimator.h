@@ -5,13 +5,21 @@
 #ifndef VIDEO_DETECT_INCLUDE_VIDEO_DETECT_FRAME_SIZE_ESTIMATOR_H_
 #define VIDEO_DETECT_INCLUDE_VIDEO_DETECT_FRAME_SIZE_ESTIMATOR_H_
 
-#include <map>
+#include <cstddef>
 #include <string>
 #include <utility>
+#include <vector>
 #include <atomic>
 
+#include "video-detect/divisor_votes.h"
+#include "video-detect/estimator.h"
+#include "video-detect/mat/buffer_pool.h"
+#include "video-detect/mat/conv_u8.h"
+#include "video-detect/mat/edge_pipeline.h"
+#include "video-detect/mat/line_features.h"
 #include "video-detect/mat/mat_2d.h"
-#include "video-detect/util/object_receiver.h"
+#include "video-detect/mat/mat_2d_view.h"
+#include "video-detect/mat/threshold.h"
 
 namespace video_detect {
 
@@ -21,8 +29,7 @@ namespace video_detect {
  * edges are then analysed to search for specific frame sizes which would make
  * up the video for example in a conference call.
  */
-class FrameSizeEstimator
-    : public util::ObjectReceiver<const mat::Mat2D<uint8_t> &> {
+class FrameSizeEstimator : public Estimator {
  public:
   /**
    * @brief Construct a new FrameSizeEstimator object
@@ -31,10 +38,11 @@ class FrameSizeEstimator
    * @param export_path the path to where the images will be exported
    * @param confidence_level the confidence level over which the frame size will
    *                         be accepted to confidently be correct
+   * @param max_grid_size the maximum amount of frames along the height or the
+   *                      width of the video
    */
-  explicit FrameSizeEstimator(bool export_images,
-                              const std::string &export_path,
-                              int confidence_level);
+  FrameSizeEstimator(bool export_images, const std::string &export_path,
+                     int confidence_level, int max_grid_size);
 
   /**
    * @brief The Accept method expects a grayscale image
@@ -43,49 +51,58 @@ class FrameSizeEstimator
    */
   void Accept(const mat::Mat2D<uint8_t> &mat) override;
 
+  std::pair<int, int> GetBestEstimateFrameSize() override;
+
+  bool HasBestEstimate() const override { return best_estimate_found_; }
+
+  void Merge(const Estimator &other) override;
+
   /**
-   * @brief Get the Best Estimate Frame Size for the input video
-   *
-   * @return std::pair<int, int> the best estimate frame size as
-   *                             a pair [width, height]
+   * @brief Get the amount of scratch buffers allocated for the intermediate
+   * images. After the first frame of a given size this stays constant.
    */
-  std::pair<int, int> GetBestEstimateFrameSize();
-
-/**
- * @brief Check if a best estimate has been found
- * 
- * @return true if a best estimate has been found
- * @return false if a best estimate has not been found
- */
-  bool HasBestEstimate() const {
-      return best_estimate_found_;
+  std::size_t GetScratchAllocationCount() const {
+    return scratch_.GetAllocationCount();
   }
 
  private:
   const bool export_images_;
   const std::string export_path_;
   const int confidence_level_;
-  std::map<int, int> rows_;
-  std::map<int, int> cols_;
+  DivisorVotes rows_;
+  DivisorVotes cols_;
   std::pair<int, int> frame_size_;
   std::atomic<bool> best_estimate_found_;
+  mat::BufferPool<uint8_t> scratch_;
+  mat::FixedPointKernel gaussian_kernel_;
+  const mat::Threshold<uint8_t> threshold_;
+  const mat::EdgePipeline edge_pipeline_;
+  mat::LineFeatureFinder line_feature_finder_;
+
+  /**
+   * A pixel where a horizontal and a vertical line cross
+   */
+  struct Corner {
+    int row;
+    int col;
+  };
+  std::vector<Corner> corners_;  // reused across frames
 
-  typedef const mat::Mat2D<uint8_t> ConstMatU8;
   typedef mat::Mat2D<uint8_t> MatU8;
+  typedef mat::Mat2DView<uint8_t> ViewU8;
+  typedef mat::Mat2DView<const uint8_t> ConstViewU8;
+
+  void ExportImage(ConstViewU8 mat, const std::string &name_base);
+  MatU8 ApplyEdgeFilters(ConstViewU8 mat);
+  MatU8 ApplyGaussianFilter(ConstViewU8 mat);
+  void ApplyThresholdFilter(ViewU8 mat);
+  MatU8 ApplyEdgeDetectionFilter(ConstViewU8 mat);
+  MatU8 ApplyContourFinder(ConstViewU8 mat);
+  MatU8 ApplyLinearFeatureFinder(ConstViewU8 mat);
+  const std::vector<Corner> &ApplyCornerFinder(ConstViewU8 mat);
 
-  void ExportImage(ConstMatU8 &mat,                // NOLINT(runtime/references)
-                   const std::string &name_base);  // NOLINT(runtime/references)
-  MatU8 ApplyGaussianFilter(ConstMatU8 &mat);      // NOLINT(runtime/references)
-  MatU8 ApplyThresholdFilter(ConstMatU8 &mat);     // NOLINT(runtime/references)
-  MatU8 ApplyEdgeDetectionFilter(
-      ConstMatU8 &mat);                       // NOLINT(runtime/references)
-  MatU8 ApplyContourFinder(ConstMatU8 &mat);  // NOLINT(runtime/references)
-  MatU8 ApplyLinearFeatureFinder(
-      ConstMatU8 &mat);  // NOLINT(runtime/references)
-  std::map<int, int> ApplyCornerFinder(
-      ConstMatU8 &mat);  // NOLINT(runtime/references)
-
-  void UpdateFrameSizes(std::map<int, int> corners, int width, int height);
+  void UpdateFrameSizes(const std::vector<Corner> &corners, int rows,
+                        int cols);
   void UpdateBestEstimateFrameSizes(int rows, int cols, int boundary);
 };
 
@@ -0,0 +1,77 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#ifndef VIDEO_DETECT_INCLUDE_VIDEO_DETECT_GRID_ESTIMATOR_H_
+#define VIDEO_DETECT_INCLUDE_VIDEO_DETECT_GRID_ESTIMATOR_H_
+
+#include <atomic>
+#include <cstdint>
+#include <utility>
+
+#include "video-detect/estimator.h"
+#include "video-detect/grid_votes.h"
+#include "video-detect/mat/mat_2d.h"
+
+namespace video_detect {
+
+/**
+ * The GridEstimator class is the base of the engines which vote on every image
+ * for the amount of rows and columns of frames in the grid. It counts the
+ * votes, turns the most voted grid into the best estimate frame size once the
+ * confidence level is reached and merges the votes of estimators of the same
+ * engine.
+ */
+class GridEstimator : public Estimator {
+ public:
+  std::pair<int, int> GetBestEstimateFrameSize() override;
+
+  bool HasBestEstimate() const override { return best_estimate_found_; }
+
+  void Merge(const Estimator &other) override;
+
+ protected:
+  /**
+   * @brief Construct a new GridEstimator object
+   *
+   * @param print_votes a boolean flag indicating whether to print the votes
+   * @param confidence_level the amount of images that have to vote for the
+   *                         same grid before it is accepted
+   * @param max_grid_size the maximum amount of frames along the height or the
+   *                      width of the video
+   */
+  GridEstimator(bool print_votes, int confidence_level, int max_grid_size);
+
+  /**
+   * @brief Vote for the grid found on an image and update the best estimate
+   *
+   * @param mat  the image the grid was found on
+   * @param rows the amount of rows of frames, in [1, max_grid_size]
+   * @param cols the amount of columns of frames, in [1, max_grid_size]
+   */
+  void Vote(const mat::Mat2D<uint8_t> &mat, int rows, int cols);
+
+  /**
+   * @brief Print engine specific details after the votes of an image
+   */
+  virtual void PrintVoteDetails() const {}
+
+  const GridVotes &GetVotes() const { return votes_; }
+
+  int GetMaxGridSize() const { return max_grid_size_; }
+
+ private:
+  const bool print_votes_;
+  const int confidence_level_;
+  const int max_grid_size_;
+  GridVotes votes_;
+  std::pair<int, int> image_size_;  // the [rows, cols] of the last image
+  std::pair<int, int> frame_size_;
+  std::atomic<bool> best_estimate_found_;
+
+  void UpdateBestEstimateFrameSize(int rows, int cols);
+};
+
+}  // namespace video_detect
+
+#endif  // VIDEO_DETECT_INCLUDE_VIDEO_DETECT_GRID_ESTIMATOR_H_
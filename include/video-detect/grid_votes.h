@@ -0,0 +1,80 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#ifndef VIDEO_DETECT_INCLUDE_VIDEO_DETECT_GRID_VOTES_H_
+#define VIDEO_DETECT_INCLUDE_VIDEO_DETECT_GRID_VOTES_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace video_detect {
+
+/**
+ * The GridVotes class counts the votes of images for the amount of rows and
+ * columns of frames in a video grid. The most voted amounts are the grid. The
+ * votes of several objects can be merged in any order.
+ */
+class GridVotes {
+ public:
+  /**
+   * @brief Construct a new GridVotes object
+   *
+   * @param max_grid_size the maximum amount of frames along the height or the
+   *                      width of the video
+   */
+  explicit GridVotes(int max_grid_size)
+      : row_votes_(max_grid_size + 1, 0), col_votes_(max_grid_size + 1, 0) {}
+
+  /**
+   * @brief Vote for a grid
+   *
+   * @param rows the amount of rows of frames, in [1, max_grid_size]
+   * @param cols the amount of columns of frames, in [1, max_grid_size]
+   */
+  void Vote(int rows, int cols) {
+    row_votes_[rows]++;
+    col_votes_[cols]++;
+  }
+
+  /**
+   * @brief Get the most voted amount of rows, the smallest amount wins a tie.
+   * It is 1 before the first vote.
+   */
+  int GetRowCount() const { return GetMostVoted(row_votes_); }
+
+  /**
+   * @brief Get the most voted amount of columns, the smallest amount wins a
+   * tie. It is 1 before the first vote.
+   */
+  int GetColCount() const { return GetMostVoted(col_votes_); }
+
+  /**
+   * @brief Add the votes of another object
+   *
+   * @param other the votes to add, with the same maximum grid size
+   */
+  void Merge(const GridVotes &other) {
+    for (std::size_t i = 0; i < row_votes_.size(); i++) {
+      row_votes_[i] += other.row_votes_[i];
+      col_votes_[i] += other.col_votes_[i];
+    }
+  }
+
+  int GetRowVotes(int rows) const { return row_votes_[rows]; }
+  int GetColVotes(int cols) const { return col_votes_[cols]; }
+
+ private:
+  std::vector<int> row_votes_;  // the votes of every amount of rows
+  std::vector<int> col_votes_;  // the votes of every amount of columns
+
+  static int GetMostVoted(const std::vector<int> &votes) {
+    return static_cast<int>(
+        std::max_element(votes.begin() + 1, votes.end()) - votes.begin());
+  }
+};
+
+}  // namespace video_detect
+
+#endif  // VIDEO_DETECT_INCLUDE_VIDEO_DETECT_GRID_VOTES_H_
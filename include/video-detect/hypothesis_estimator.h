@@ -0,0 +1,97 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#ifndef VIDEO_DETECT_INCLUDE_VIDEO_DETECT_HYPOTHESIS_ESTIMATOR_H_
+#define VIDEO_DETECT_INCLUDE_VIDEO_DETECT_HYPOTHESIS_ESTIMATOR_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "video-detect/grid_estimator.h"
+#include "video-detect/mat/mat_2d.h"
+#include "video-detect/mat/mat_2d_view.h"
+
+namespace video_detect {
+
+/**
+ * The HypothesisEstimator class checks every candidate grid of equal frames
+ * directly on the image. The edge strength of a grid is only sampled along
+ * its boundary lines and along the control lines halfway between them. A grid
+ * wins if its weakest boundary is stronger than its strongest control line by
+ * a margin. The grids along the height and along the width are checked
+ * separately, as their boundaries do not depend on each other.
+ *
+ * The grid voted for most so far is checked first. If it wins, its multiples
+ * are checked from the largest down, as a divisor of the grid wins as well.
+ * Otherwise the other grids are checked from the largest amount of frames
+ * down, stopping at the first one that wins.
+ * A grid is rejected at its first weak boundary, so only a few thousand
+ * pixels on the candidate lines are read per image.
+ */
+class HypothesisEstimator : public GridEstimator {
+ public:
+  /**
+   * @brief Construct a new HypothesisEstimator object
+   *
+   * @param print_votes a boolean flag indicating whether to print the votes
+   * @param confidence_level the amount of images that have to vote for the
+   *                         same grid before it is accepted
+   * @param max_grid_size the maximum amount of frames along the height or the
+   *                      width of the video
+   * @param margin the factor by which the weakest boundary of a grid must be
+   *               stronger than its strongest control line, larger than 1
+   */
+  HypothesisEstimator(bool print_votes, int confidence_level,
+                      int max_grid_size, float margin);
+
+  /**
+   * @brief The Accept method expects a grayscale image
+   *
+   * @param mat this is a 2D single channel unsigned char matrix
+   */
+  void Accept(const mat::Mat2D<uint8_t> &mat) override;
+
+  /**
+   * @brief Get the amount of pixels read from the last image
+   */
+  std::size_t GetLastReadCount() const { return read_count_; }
+
+  // The minimum mean gradient of a boundary, to ignore flat images
+  static constexpr float kMinStrength = 4.f;
+
+ protected:
+  void PrintVoteDetails() const override;
+
+ private:
+  const float margin_;
+  std::size_t read_count_ = 0;
+
+  /**
+   * The dimension along which the frames are counted, the boundaries of the
+   * rows of frames are horizontal lines and those of the columns vertical
+   */
+  enum class Axis { kRows, kCols };
+
+  /**
+   * The mean gradient across a line of the pixels sampled along it, the line
+   * at position p lies between the rows or columns p - 1 and p
+   */
+  float GetLineStrength(mat::Mat2DView<const uint8_t> mat, Axis axis,
+                        int position);
+
+  /**
+   * Find the amount of frames along one axis, checking the hint and its
+   * multiples first
+   */
+  int FindGridCount(mat::Mat2DView<const uint8_t> mat, Axis axis, int hint);
+
+  /**
+   * Check whether an amount of frames along one axis wins
+   */
+  bool IsGridCount(mat::Mat2DView<const uint8_t> mat, Axis axis, int count);
+};
+
+}  // namespace video_detect
+
+#endif  // VIDEO_DETECT_INCLUDE_VIDEO_DETECT_HYPOTHESIS_ESTIMATOR_H_
@@ -0,0 +1,67 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#ifndef VIDEO_DETECT_INCLUDE_VIDEO_DETECT_MAT_ALIGNED_ALLOCATOR_H_
+#define VIDEO_DETECT_INCLUDE_VIDEO_DETECT_MAT_ALIGNED_ALLOCATOR_H_
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace video_detect {
+namespace mat {
+
+/**
+ * The byte alignment used for matrix buffers and matrix rows. A cache line
+ * (and the widest vector register in use) fits into this alignment.
+ */
+constexpr std::size_t kMatAlignment = 64;
+
+/**
+ * The AlignedAllocator class is a standard allocator returning storage aligned
+ * to the specified amount of bytes
+ *
+ * @tparam T the type of object to allocate
+ * @tparam Alignment the alignment in bytes (a power of two)
+ */
+template <typename T, std::size_t Alignment = kMatAlignment>
+class AlignedAllocator {
+ public:
+  typedef T value_type;
+
+  template <typename U>
+  struct rebind {
+    typedef AlignedAllocator<U, Alignment> other;
+  };
+
+  AlignedAllocator() = default;
+
+  template <typename U>
+  AlignedAllocator(const AlignedAllocator<U, Alignment> &) {}  // NOLINT
+
+  T *allocate(std::size_t count) {
+    void *ptr = nullptr;
+    if (posix_memalign(&ptr, Alignment, count * sizeof(T)) != 0) {
+      throw std::bad_alloc();
+    }
+    return static_cast<T *>(ptr);
+  }
+
+  void deallocate(T *ptr, std::size_t) { std::free(ptr); }
+
+  template <typename U>
+  bool operator==(const AlignedAllocator<U, Alignment> &) const {
+    return true;
+  }
+
+  template <typename U>
+  bool operator!=(const AlignedAllocator<U, Alignment> &) const {
+    return false;
+  }
+};
+
+}  // namespace mat
+}  // namespace video_detect
+
+#endif  // VIDEO_DETECT_INCLUDE_VIDEO_DETECT_MAT_ALIGNED_ALLOCATOR_H_
@@ -0,0 +1,54 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#ifndef VIDEO_DETECT_INCLUDE_VIDEO_DETECT_MAT_BORDER_H_
+#define VIDEO_DETECT_INCLUDE_VIDEO_DETECT_MAT_BORDER_H_
+
+namespace video_detect {
+namespace mat {
+
+/**
+ * The BorderMode determines how a neighbourhood operation treats values
+ * outside the source matrix
+ */
+enum class BorderMode {
+  kZero,       // 000|abcd|000 values outside are zero (default)
+  kReplicate,  // aaa|abcd|ddd the edge values are repeated
+  kReflect,    // dcb|abcd|cba mirrored at the edge without repeating it
+  kSkip        // the border of the result is left untouched
+};
+
+/**
+ * @brief Map a coordinate onto the source according to the border mode
+ *
+ * @param index  the coordinate, possibly outside the source
+ * @param size   the amount of values along the axis
+ * @param border the border mode
+ * @return int the coordinate inside the source, or -1 if the value is zero
+ */
+inline int MapBorderIndex(int index, int size, BorderMode border) {
+  if (index >= 0 && index < size) {
+    return index;
+  }
+  switch (border) {
+    case BorderMode::kReplicate:
+      return index < 0 ? 0 : size - 1;
+    case BorderMode::kReflect:
+      if (size == 1) {
+        return 0;
+      }
+      // Mirror until inside, more than once for kernels larger than the source
+      while (index < 0 || index >= size) {
+        index = index < 0 ? -index : 2 * (size - 1) - index;
+      }
+      return index;
+    default:
+      return -1;
+  }
+}
+
+}  // namespace mat
+}  // namespace video_detect
+
+#endif  // VIDEO_DETECT_INCLUDE_VIDEO_DETECT_MAT_BORDER_H_
@@ -0,0 +1,116 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#ifndef VIDEO_DETECT_INCLUDE_VIDEO_DETECT_MAT_BUFFER_POOL_H_
+#define VIDEO_DETECT_INCLUDE_VIDEO_DETECT_MAT_BUFFER_POOL_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+#include "video-detect/mat/aligned_allocator.h"
+#include "video-detect/mat/mat_2d.h"
+
+namespace video_detect {
+namespace mat {
+
+/**
+ * The BufferPool class hands out matrices whose buffers are recycled. A
+ * buffer returns to the pool as soon as the last matrix using it is destroyed
+ * and is reused by a later request of the same or a smaller size. Once a
+ * sequence of requests has been served, repeating it allocates nothing.
+ *
+ * Matrices may outlive the pool, their buffers are then freed with them.
+ *
+ * @tparam T the type of the matrix values
+ */
+template <typename T>
+class BufferPool {
+ public:
+  /**
+   * @brief Acquire a matrix with unspecified contents
+   *
+   * @param rows the amount of rows (y)
+   * @param cols the amount of colums (x)
+   * @return Mat2D<T> the matrix backed by a pooled buffer
+   */
+  Mat2D<T> Acquire(int rows, int cols) {
+    const int kStride = Mat2D<T>::GetAlignedStride(cols);
+    std::shared_ptr<Block> block =
+        FindOrAllocate(static_cast<std::size_t>(rows) * kStride);
+    return Mat2D<T>(block->data, rows, cols, kStride, block);
+  }
+
+  /**
+   * @brief Acquire a matrix with value-initialized contents
+   *
+   * @param rows the amount of rows (y)
+   * @param cols the amount of colums (x)
+   * @return Mat2D<T> the matrix backed by a pooled buffer
+   */
+  Mat2D<T> AcquireZeroed(int rows, int cols) {
+    Mat2D<T> result = Acquire(rows, cols);
+    std::fill_n(result.GetRowPtr(0),
+                static_cast<std::size_t>(rows) * result.GetStride(), T());
+    return result;
+  }
+
+  /**
+   * @brief Get the amount of buffers allocated by this pool so far
+   */
+  std::size_t GetAllocationCount() const {
+    std::lock_guard<std::mutex> lock_guard(access_);
+    return allocation_count_;
+  }
+
+ private:
+  static_assert(std::is_trivially_destructible<T>::value,
+                "Pooled values are not destructed");
+
+  struct Block {
+    explicit Block(std::size_t size)
+        : data(AlignedAllocator<T>().allocate(std::max<std::size_t>(size, 1))),
+          capacity(size) {}
+    ~Block() { AlignedAllocator<T>().deallocate(data, capacity); }
+    Block(const Block &) = delete;
+    Block &operator=(const Block &) = delete;
+
+    T *data;
+    std::size_t capacity;
+  };
+
+  mutable std::mutex access_;
+  std::vector<std::shared_ptr<Block>> blocks_;
+  std::size_t allocation_count_ = 0;
+
+  std::shared_ptr<Block> FindOrAllocate(std::size_t size) {
+    std::lock_guard<std::mutex> lock_guard(access_);
+
+    // A block only referenced by the pool is free, pick the smallest fitting
+    std::shared_ptr<Block> *best = nullptr;
+    for (auto &block : blocks_) {
+      if (block.use_count() == 1 && block->capacity >= size &&
+          (best == nullptr || block->capacity < (*best)->capacity)) {
+        best = &block;
+      }
+    }
+    if (best != nullptr) {
+      return *best;
+    }
+
+    // Allocate a new block
+    blocks_.push_back(std::make_shared<Block>(size));
+    ++allocation_count_;
+    return blocks_.back();
+  }
+};
+
+}  // namespace mat
+}  // namespace video_detect
+
+#endif  // VIDEO_DETECT_INCLUDE_VIDEO_DETECT_MAT_BUFFER_POOL_H_
@@ -0,0 +1,32 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#ifndef VIDEO_DETECT_INCLUDE_VIDEO_DETECT_MAT_CONTOUR_H_
+#define VIDEO_DETECT_INCLUDE_VIDEO_DETECT_MAT_CONTOUR_H_
+
+#include <cstdint>
+
+#include "video-detect/mat/mat_2d_view.h"
+
+namespace video_detect {
+namespace mat {
+
+/**
+ * @brief Mark the boundary pixels of the regions of non-zero values, these
+ * are the pixels border following (e.g. findContours) visits for the outer
+ * and the hole borders of 8-connected regions. A non-zero value is on a
+ * boundary if one of its 4-neighbours is zero or outside the source. No
+ * contours or hierarchy are built, the mask is written directly.
+ *
+ * @param mat    the source values, any non-zero value is part of a region
+ * @param result the destination with the same size as the source, boundary
+ *               pixels are set to 255 and all others to 0. It must not
+ *               overlap the source.
+ */
+void ContourMask(Mat2DView<const uint8_t> mat, Mat2DView<uint8_t> result);
+
+}  // namespace mat
+}  // namespace video_detect
+
+#endif  // VIDEO_DETECT_INCLUDE_VIDEO_DETECT_MAT_CONTOUR_H_
@@ -5,61 +5,457 @@
 #ifndef VIDEO_DETECT_INCLUDE_VIDEO_DETECT_MAT_CONV_H_
 #define VIDEO_DETECT_INCLUDE_VIDEO_DETECT_MAT_CONV_H_
 
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
+#include "video-detect/mat/border.h"
+#include "video-detect/mat/kernel.h"
 #include "video-detect/mat/mat_2d.h"
+#include "video-detect/mat/mat_2d_view.h"
+#include "video-detect/util/thread_pool.h"
 
 namespace video_detect {
 namespace mat {
 
+namespace internal {
+
+/**
+ * Calculate a single value of the convolution with bounds checks, values
+ * outside the source are mapped according to the border mode
+ */
+template <typename MatType, typename KernelMat>
+MatType ConvMat2DValue(Mat2DView<const MatType> mat, const KernelMat &kernel,
+                       int row, int col, BorderMode border) {
+  typedef typename KernelMat::ValueType KernelType;
+
+  // Determine offsets
+  const int kRowOffset = kernel.GetRowCount() / 2;
+  const int kColOffset = kernel.GetColCount() / 2;
+
+  // Perform the matrix multiplication
+  KernelType sum{};
+
+  for (int x = 0; x < kernel.GetColCount(); x++) {
+    for (int y = 0; y < kernel.GetRowCount(); y++) {
+      // Get the target matrix coordinate while taking into account the
+      // offset of the Mat2D coordinates
+      const int kRowTarget =
+          MapBorderIndex(row - kRowOffset + y, mat.GetRowCount(), border);
+      const int kColTarget =
+          MapBorderIndex(col - kColOffset + x, mat.GetColCount(), border);
+
+      // Only run the summation if the target coordinate is in the bounds
+      if (kRowTarget >= 0 && kColTarget >= 0) {
+        // Multiply the matrix value with the corresponding kernel value
+        sum += mat.At(kRowTarget, kColTarget) * kernel.At(y, x);
+      }
+    }
+  }
+
+  return static_cast<MatType>(sum);
+}
+
+/**
+ * Convolute with any kernel type providing GetRowCount, GetColCount and At.
+ * The interior, where all the taps are in bounds, is calculated without any
+ * checks. A block of values is calculated at a time such that their sums are
+ * independent of each other, every value is summed in the same order. The
+ * loops over the taps have constant bounds for fixed size kernels, which the
+ * compiler unrolls. The border is calculated separately. Bands of rows are
+ * calculated in parallel, they read their neighbouring rows from the source.
+ */
+template <typename MatType, typename KernelMat>
+void ConvMat2D(Mat2DView<const MatType> mat, const KernelMat &kernel,
+               Mat2DView<MatType> result, BorderMode border) {
+  typedef typename KernelMat::ValueType KernelType;
+  constexpr int kBlock = 8;
+  const int rows = mat.GetRowCount();
+  const int cols = mat.GetColCount();
+  const int stride = mat.GetStride();
+
+  // Determine offsets
+  const int kRowOffset = kernel.GetRowCount() / 2;
+  const int kColOffset = kernel.GetColCount() / 2;
+
+  // Determine the interior
+  const int kRowBegin = std::min(kRowOffset, rows);
+  const int kRowEnd =
+      std::max(kRowBegin, rows - (kernel.GetRowCount() - 1 - kRowOffset));
+  const int kColBegin = std::min(kColOffset, cols);
+  const int kColEnd =
+      std::max(kColBegin, cols - (kernel.GetColCount() - 1 - kColOffset));
+
+  auto conv_rows = [&](int row_begin, int row_end) {
+    for (int row = row_begin; row < row_end; row++) {
+      MatType *dst = result.GetRowPtr(row);
+      const bool kBorderRow = row < kRowBegin || row >= kRowEnd;
+
+      // The border
+      if (border != BorderMode::kSkip) {
+        for (int col = 0; col < cols; col++) {
+          if (kBorderRow || col < kColBegin || col >= kColEnd) {
+            dst[col] = ConvMat2DValue(mat, kernel, row, col, border);
+          }
+        }
+      }
+      if (kBorderRow) {
+        continue;
+      }
+
+      // The interior
+      const MatType *src = mat.GetRowPtr(row - kRowOffset) - kColOffset;
+      int col = kColBegin;
+      for (; col + kBlock <= kColEnd; col += kBlock) {
+        KernelType sums[kBlock] = {};
+        for (int x = 0; x < kernel.GetColCount(); x++) {
+          for (int y = 0; y < kernel.GetRowCount(); y++) {
+            const KernelType kKernelValue = kernel.At(y, x);
+            const MatType *taps = src + y * stride + col + x;
+            for (int i = 0; i < kBlock; i++) {
+              sums[i] += taps[i] * kKernelValue;
+            }
+          }
+        }
+        for (int i = 0; i < kBlock; i++) {
+          dst[col + i] = static_cast<MatType>(sums[i]);
+        }
+      }
+      for (; col < kColEnd; col++) {
+        KernelType sum{};
+        for (int x = 0; x < kernel.GetColCount(); x++) {
+          for (int y = 0; y < kernel.GetRowCount(); y++) {
+            sum += src[y * stride + col + x] * kernel.At(y, x);
+          }
+        }
+        dst[col] = static_cast<MatType>(sum);
+      }
+    }
+  };
+  util::ParallelForRows(rows, cols * sizeof(MatType), conv_rows);
+}
+
+/**
+ * Convolute with a separable kernel given as any row and column kernel types,
+ * bands of rows are calculated in parallel
+ */
+template <typename MatType, typename RowKernel, typename ColKernel>
+void SepConvMat2D(Mat2DView<const MatType> mat, const RowKernel &row_kernel,
+                  const ColKernel &col_kernel, Mat2DView<MatType> result,
+                  BorderMode border) {
+  typedef typename RowKernel::ValueType KernelType;
+  typedef decltype(MatType() * KernelType()) Accumulator;
+  const int rows = mat.GetRowCount();
+  const int cols = mat.GetColCount();
+  const int kRowTaps = col_kernel.GetRowCount();
+  const int kColTaps = row_kernel.GetColCount();
+
+  // Determine offsets
+  const int kRowOffset = kRowTaps / 2;
+  const int kColOffset = kColTaps / 2;
+
+  // Determine the interior, only needed when skipping the border
+  const bool kSkip = border == BorderMode::kSkip;
+  const int kRowBegin = kSkip ? std::min(kRowOffset, rows) : 0;
+  const int kRowEnd =
+      kSkip ? std::max(kRowBegin, rows - (kRowTaps - 1 - kRowOffset)) : rows;
+  const int kColBegin = kSkip ? std::min(kColOffset, cols) : 0;
+  const int kColEnd =
+      kSkip ? std::max(kColBegin, cols - (kColTaps - 1 - kColOffset)) : cols;
+
+  auto conv_rows = [&](int band_begin, int band_end) {
+    // The column sums of one row, padded on both sides so that the
+    // horizontal pass needs no bounds checks. The buffer is kept per thread
+    // and only grows.
+    static thread_local std::vector<Accumulator> line;
+    line.resize(std::max<std::size_t>(line.size(), cols + kColTaps));
+    std::fill(line.begin(), line.end(), Accumulator());
+    Accumulator *sums = line.data() + kColOffset;
+
+    for (int row = kRowBegin + band_begin; row < kRowBegin + band_end;
+         row++) {
+      // Vertical pass, rows outside the bounds are mapped by the border mode
+      std::fill(sums, sums + cols, Accumulator());
+      for (int y = 0; y < kRowTaps; y++) {
+        const int kRowTarget =
+            MapBorderIndex(row - kRowOffset + y, rows, border);
+        const KernelType kKernelValue = col_kernel.At(y, 0);
+        if (kRowTarget < 0 || kKernelValue == 0) {
+          continue;
+        }
+        const MatType *src = mat.GetRowPtr(kRowTarget);
+        for (int col = 0; col < cols; col++) {
+          sums[col] += src[col] * kKernelValue;
+        }
+      }
+
+      // Pad the column sums according to the border mode
+      if (border == BorderMode::kReplicate || border == BorderMode::kReflect) {
+        for (int col = -kColOffset; col < 0; col++) {
+          sums[col] = sums[MapBorderIndex(col, cols, border)];
+        }
+        for (int col = cols; col < cols + kColTaps - 1 - kColOffset; col++) {
+          sums[col] = sums[MapBorderIndex(col, cols, border)];
+        }
+      }
+
+      // Horizontal pass over the column sums
+      MatType *dst = result.GetRowPtr(row);
+      for (int col = kColBegin; col < kColEnd; col++) {
+        const Accumulator *taps = sums + col - kColOffset;
+        Accumulator sum{};
+        for (int x = 0; x < kColTaps; x++) {
+          sum += taps[x] * row_kernel.At(0, x);
+        }
+
+        // Set the new pixel value
+        dst[col] = static_cast<MatType>(sum);
+      }
+    }
+  };
+  util::ParallelForRows(kRowEnd - kRowBegin, cols * sizeof(MatType),
+                        conv_rows);
+}
+
+}  // namespace internal
+
+/**
+ * @brief Convolute a matrix with a kernel into an existing result. Values
+ * outside the source are treated as zero unless specified otherwise.
+ *
+ * @param mat    the source values
+ * @param kernel the kernel to convolute with
+ * @param result the destination, must have the same size as the source and
+ *               must not overlap it
+ * @param border the treatment of values outside the source
+ */
+template <typename MatType,
+          typename = std::enable_if_t<std::is_arithmetic<MatType>::value>,
+          typename KernelType = MatType,
+          typename = std::enable_if_t<std::is_arithmetic<KernelType>::value>>
+void ConvMat2D(Mat2DView<const MatType> mat, const Mat2D<KernelType> &kernel,
+               Mat2DView<MatType> result,
+               BorderMode border = BorderMode::kZero) {
+  internal::ConvMat2D(mat, kernel, result, border);
+}
+
+/**
+ * @brief Convolute a matrix with a fixed size kernel into an existing result,
+ * the loops over the kernel taps are unrolled
+ */
+template <typename MatType,
+          typename = std::enable_if_t<std::is_arithmetic<MatType>::value>,
+          typename KernelType = MatType, int Rows = 1, int Cols = 1,
+          typename = std::enable_if_t<std::is_arithmetic<KernelType>::value>>
+void ConvMat2D(Mat2DView<const MatType> mat,
+               const Kernel<KernelType, Rows, Cols> &kernel,
+               Mat2DView<MatType> result,
+               BorderMode border = BorderMode::kZero) {
+  internal::ConvMat2D(mat, kernel, result, border);
+}
+
 template <typename MatType,
           typename = std::enable_if_t<std::is_arithmetic<MatType>::value>,
           typename KernelType = MatType,
           typename = std::enable_if_t<std::is_arithmetic<KernelType>::value>>
 Mat2D<MatType> ConvMat2D(const Mat2D<MatType> &mat,
-                         const Mat2D<KernelType> &kernel) {
+                         const Mat2D<KernelType> &kernel,
+                         BorderMode border = BorderMode::kZero) {
   // Create an empty matrix for the result
-  int rows = mat.GetRowCount();
-  int cols = mat.GetColCount();
+  Mat2D<MatType> result(mat.GetRowCount(), mat.GetColCount());
 
-  Mat2D<MatType> result(rows, cols);
+  ConvMat2D<MatType>(mat.View(), kernel, result.View(), border);
 
-  // Determine offsets
-  const int kRowOffset = kernel.GetRowCount() / 2;
-  const int kColOffset = kernel.GetColCount() / 2;
+  return result;
+}
 
-  // Mat2D - Traverse the matrix
-  for (int row = 0; row < rows; row++) {
-    for (int col = 0; col < cols; col++) {
-      // Perform the matrix multiplication
-      KernelType sum{};
-
-      for (int x = 0; x < kernel.GetColCount(); x++) {
-        for (int y = 0; y < kernel.GetRowCount(); y++) {
-          // Get the Mat2D value at this point
-          const KernelType kKernelValue = kernel.GetValue(y, x);
-
-          // Get the target matrix coordinate while taking into account the
-          // offset of the Mat2D coordinates
-          const int kRowTarget = row - kRowOffset + y;
-          const int kColTarget = col - kColOffset + x;
-
-          // Only run the summation if the target coordinate is in the bounds
-          if (kRowTarget >= 0 && kColTarget >= 0 && kRowTarget < rows &&
-              kColTarget < cols) {
-            // Multiply the matrix value with the corresponding kernel value
-            sum += mat.GetValue(kRowTarget, kColTarget) * kKernelValue;
-          }
-        }
+template <typename MatType,
+          typename = std::enable_if_t<std::is_arithmetic<MatType>::value>,
+          typename KernelType = MatType, int Rows = 1, int Cols = 1,
+          typename = std::enable_if_t<std::is_arithmetic<KernelType>::value>>
+Mat2D<MatType> ConvMat2D(const Mat2D<MatType> &mat,
+                         const Kernel<KernelType, Rows, Cols> &kernel,
+                         BorderMode border = BorderMode::kZero) {
+  // Create an empty matrix for the result
+  Mat2D<MatType> result(mat.GetRowCount(), mat.GetColCount());
+
+  ConvMat2D<MatType>(mat.View(), kernel, result.View(), border);
+
+  return result;
+}
+
+/**
+ * @brief Convolute a matrix with a separable kernel into an existing result.
+ * The kernel is the outer product of a column kernel (K x 1) and a row kernel
+ * (1 x K), which takes 2K instead of K * K multiply-adds per value. Values
+ * outside the source are treated as in ConvMat2D.
+ *
+ * Integral kernels are accumulated in the promoted type of the product, so the
+ * result equals ConvMat2D modulo the range of the matrix type.
+ *
+ * @param mat        the source values
+ * @param row_kernel the horizontal kernel, a single row
+ * @param col_kernel the vertical kernel, a single column
+ * @param result     the destination, must have the same size as the source
+ *                   and must not overlap it
+ * @param border     the treatment of values outside the source
+ */
+template <typename MatType,
+          typename = std::enable_if_t<std::is_arithmetic<MatType>::value>,
+          typename KernelType = MatType,
+          typename = std::enable_if_t<std::is_arithmetic<KernelType>::value>>
+void SepConvMat2D(Mat2DView<const MatType> mat,
+                  const Mat2D<KernelType> &row_kernel,
+                  const Mat2D<KernelType> &col_kernel,
+                  Mat2DView<MatType> result,
+                  BorderMode border = BorderMode::kZero) {
+  internal::SepConvMat2D(mat, row_kernel, col_kernel, result, border);
+}
+
+/**
+ * @brief Convolute a matrix with a fixed size separable kernel into an
+ * existing result, the loops over the kernel taps are unrolled
+ */
+template <typename MatType,
+          typename = std::enable_if_t<std::is_arithmetic<MatType>::value>,
+          typename KernelType = MatType, int Rows = 1, int Cols = 1,
+          typename = std::enable_if_t<std::is_arithmetic<KernelType>::value>>
+void SepConvMat2D(Mat2DView<const MatType> mat,
+                  const Kernel<KernelType, 1, Cols> &row_kernel,
+                  const Kernel<KernelType, Rows, 1> &col_kernel,
+                  Mat2DView<MatType> result,
+                  BorderMode border = BorderMode::kZero) {
+  internal::SepConvMat2D(mat, row_kernel, col_kernel, result, border);
+}
+
+namespace internal {
+
+/**
+ * Get the greatest common divisor of the integral values of a matrix
+ */
+template <typename T>
+std::enable_if_t<std::is_integral<T>::value, T> GetCommonDivisor(
+    const Mat2D<T> &mat) {
+  int divisor = 0;
+  for (int row = 0; row < mat.GetRowCount(); row++) {
+    for (int col = 0; col < mat.GetColCount(); col++) {
+      int value = std::abs(static_cast<int>(mat.At(row, col)));
+      while (value != 0) {
+        const int kRemainder = divisor % value;
+        divisor = value;
+        value = kRemainder;
+      }
+    }
+  }
+  return static_cast<T>(divisor);
+}
+
+/**
+ * Floating point values are divided exactly, their common divisor is one
+ */
+template <typename T>
+std::enable_if_t<std::is_floating_point<T>::value, T> GetCommonDivisor(
+    const Mat2D<T> &) {
+  return T(1);
+}
+
+template <typename T>
+std::enable_if_t<std::is_integral<T>::value, bool> IsMultipleOf(T value,
+                                                                T divisor) {
+  return value % divisor == 0;
+}
+
+template <typename T>
+std::enable_if_t<std::is_floating_point<T>::value, bool> IsMultipleOf(T, T) {
+  return true;
+}
+
+}  // namespace internal
+
+/**
+ * @brief Factorize a kernel into a column kernel and a row kernel whose outer
+ * product equals it, i.e. check whether the kernel has rank 1
+ *
+ * @param kernel     the kernel to factorize, a Mat2D or a Kernel
+ * @param row_kernel the resultant horizontal kernel (1 x C)
+ * @param col_kernel the resultant vertical kernel (R x 1)
+ * @return true if the kernel is separable and the factors were set
+ * @return false if the kernel is not separable
+ */
+template <typename KernelMat,
+          typename KernelType = typename KernelMat::ValueType,
+          typename = std::enable_if_t<std::is_arithmetic<KernelType>::value>>
+bool FactorizeKernel(const KernelMat &kernel,
+                     Mat2D<KernelType> &row_kernel,   // NOLINT
+                     Mat2D<KernelType> &col_kernel) {  // NOLINT
+  const int kRows = kernel.GetRowCount();
+  const int kCols = kernel.GetColCount();
+
+  // Find the first row with a non-zero value, it becomes the row kernel
+  int pivot_row = -1;
+  int pivot_col = -1;
+  for (int y = 0; y < kRows && pivot_row < 0; y++) {
+    for (int x = 0; x < kCols && pivot_col < 0; x++) {
+      if (kernel.At(y, x) != 0) {
+        pivot_row = y;
+        pivot_col = x;
       }
+    }
+  }
+  if (pivot_row < 0) {
+    return false;
+  }
+
+  Mat2D<KernelType> row(1, kCols);
+  Mat2D<KernelType> col(kRows, 1);
+  for (int x = 0; x < kCols; x++) {
+    row.At(0, x) = kernel.At(pivot_row, x);
+  }
+
+  // Integral factors must stay exact, remove the common divisor of the row
+  // such that the column factors can be integral as well
+  KernelType divisor = internal::GetCommonDivisor(row);
+  if (row.At(0, pivot_col) < 0) {
+    divisor = -divisor;
+  }
+  for (int x = 0; x < kCols; x++) {
+    row.At(0, x) = static_cast<KernelType>(row.At(0, x) / divisor);
+  }
 
-      // Set the new pixel value
-      result.SetValue(row, col, static_cast<MatType>(sum));
+  // The column kernel scales the row kernel to every row of the kernel
+  for (int y = 0; y < kRows; y++) {
+    if (!internal::IsMultipleOf(kernel.At(y, pivot_col),
+                                row.At(0, pivot_col))) {
+      return false;
     }
+    col.At(y, 0) =
+        static_cast<KernelType>(kernel.At(y, pivot_col) / row.At(0, pivot_col));
   }
 
-  return result;
+  // Verify that the outer product reproduces the kernel
+  double max_abs = 0;
+  for (int y = 0; y < kRows; y++) {
+    for (int x = 0; x < kCols; x++) {
+      max_abs = std::max(max_abs, std::fabs(1.0 * kernel.At(y, x)));
+    }
+  }
+  const double kTolerance =
+      std::is_integral<KernelType>::value ? 0.0 : max_abs * 1e-5;
+  for (int y = 0; y < kRows; y++) {
+    for (int x = 0; x < kCols; x++) {
+      const double kProduct = 1.0 * col.At(y, 0) * row.At(0, x);
+      if (std::fabs(kProduct - kernel.At(y, x)) > kTolerance) {
+        return false;
+      }
+    }
+  }
+
+  row_kernel = std::move(row);
+  col_kernel = std::move(col);
+  return true;
 }
 
 }  // namespace mat
@@ -0,0 +1,135 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#ifndef VIDEO_DETECT_INCLUDE_VIDEO_DETECT_MAT_CONV_U8_H_
+#define VIDEO_DETECT_INCLUDE_VIDEO_DETECT_MAT_CONV_U8_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+
+#include "video-detect/mat/mat_2d.h"
+#include "video-detect/mat/mat_2d_view.h"
+
+namespace video_detect {
+namespace mat {
+
+/**
+ * The FixedPointKernel class holds a kernel as int16 weights scaled by two to
+ * the power of the shift. Integral kernels are held exactly with a shift of
+ * zero, floating point kernels get the largest shift (up to 14) for which all
+ * weights fit.
+ */
+class FixedPointKernel {
+ public:
+  static constexpr int kMaxShift = 14;
+
+  /**
+   * @brief Construct a new FixedPointKernel object
+   *
+   * @param kernel the kernel to convert, a Mat2D or a Kernel
+   */
+  template <typename KernelMat,
+            typename KernelType = typename KernelMat::ValueType,
+            typename = std::enable_if_t<std::is_arithmetic<KernelType>::value>>
+  explicit FixedPointKernel(const KernelMat &kernel)
+      : weights_(kernel.GetRowCount(), kernel.GetColCount()), shift_(0) {
+    // Determine the shift
+    if (std::is_floating_point<KernelType>::value) {
+      double max_abs = 0;
+      for (int y = 0; y < kernel.GetRowCount(); y++) {
+        for (int x = 0; x < kernel.GetColCount(); x++) {
+          max_abs = std::max(max_abs, std::fabs(1.0 * kernel.At(y, x)));
+        }
+      }
+      shift_ = kMaxShift;
+      while (shift_ > 0 && max_abs * (1 << shift_) > INT16_MAX) {
+        --shift_;
+      }
+    }
+
+    // Scale and round the weights
+    for (int y = 0; y < kernel.GetRowCount(); y++) {
+      for (int x = 0; x < kernel.GetColCount(); x++) {
+        const double kWeight =
+            std::round(1.0 * kernel.At(y, x) * (1 << shift_));
+        weights_.At(y, x) = static_cast<int16_t>(
+            std::max<double>(INT16_MIN, std::min<double>(INT16_MAX, kWeight)));
+      }
+    }
+  }
+
+  const Mat2D<int16_t> &GetWeights() const { return weights_; }
+  int GetShift() const { return shift_; }
+
+ private:
+  Mat2D<int16_t> weights_;
+  int shift_;
+};
+
+/**
+ * The implementations of the uint8 convolution
+ */
+enum class ConvPath { kScalar, kSse41, kAvx2 };
+
+/**
+ * @brief Check whether the CPU the program runs on supports the path
+ */
+bool IsConvPathSupported(ConvPath path);
+
+/**
+ * @brief Get the fastest path supported by the CPU, it is selected once
+ */
+ConvPath GetDefaultConvPath();
+
+/**
+ * @brief Convolute a uint8 matrix with a fixed point kernel into an existing
+ * result using the fastest path supported by the CPU. The weighted sums are
+ * accumulated in int32, shifted right by the kernel shift and saturated to
+ * the uint8 range. Values outside the source are treated as zero. All paths
+ * give identical results.
+ *
+ * @param mat    the source values
+ * @param kernel the kernel to convolute with
+ * @param result the destination, must have the same size as the source and
+ *               must not overlap it
+ */
+void ConvU8(Mat2DView<const uint8_t> mat, const FixedPointKernel &kernel,
+            Mat2DView<uint8_t> result);
+
+/**
+ * @brief Convolute a uint8 matrix with a fixed point kernel using the
+ * specified path, which must be supported by the CPU
+ */
+void ConvU8(Mat2DView<const uint8_t> mat, const FixedPointKernel &kernel,
+            Mat2DView<uint8_t> result, ConvPath path);
+
+/**
+ * @brief Convolute only a range of rows of a uint8 matrix using the fastest
+ * path supported by the CPU. The neighbouring rows are read from the whole
+ * source, so the rows are identical to those of ConvU8.
+ *
+ * @param mat       the source values
+ * @param kernel    the kernel to convolute with
+ * @param row_begin the first row to calculate
+ * @param row_end   the row after the last row to calculate
+ * @param result    the destination of the rows, the first row of the result
+ *                  receives row_begin
+ */
+void ConvU8Rows(Mat2DView<const uint8_t> mat, const FixedPointKernel &kernel,
+                int row_begin, int row_end, Mat2DView<uint8_t> result);
+
+/**
+ * @brief Convolute only a range of rows of a uint8 matrix using the specified
+ * path, which must be supported by the CPU
+ */
+void ConvU8Rows(Mat2DView<const uint8_t> mat, const FixedPointKernel &kernel,
+                int row_begin, int row_end, Mat2DView<uint8_t> result,
+                ConvPath path);
+
+}  // namespace mat
+}  // namespace video_detect
+
+#endif  // VIDEO_DETECT_INCLUDE_VIDEO_DETECT_MAT_CONV_U8_H_
@@ -0,0 +1,72 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#ifndef VIDEO_DETECT_INCLUDE_VIDEO_DETECT_MAT_EDGE_PIPELINE_H_
+#define VIDEO_DETECT_INCLUDE_VIDEO_DETECT_MAT_EDGE_PIPELINE_H_
+
+#include <cstdint>
+
+#include "video-detect/mat/conv_u8.h"
+#include "video-detect/mat/gradient.h"
+#include "video-detect/mat/mat_2d_view.h"
+#include "video-detect/mat/threshold.h"
+
+namespace video_detect {
+namespace mat {
+
+/**
+ * The EdgePipeline class streams the rows of an image through a gaussian
+ * filter, a threshold and a Sobel gradient magnitude in a single pass. Only
+ * the three smoothed rows around the current row are kept in a rolling
+ * buffer, so the intermediate images are never written to memory. The result
+ * is identical to applying ConvU8, Threshold and SobelGradient one after the
+ * other on whole images.
+ */
+class EdgePipeline {
+ public:
+  /**
+   * @brief Construct a new EdgePipeline object
+   *
+   * @param gaussian  the smoothing kernel
+   * @param threshold the threshold applied on the smoothed values
+   * @param norm      the norm of the gradient magnitude
+   */
+  EdgePipeline(const FixedPointKernel &gaussian,
+               const Threshold<uint8_t> &threshold,
+               GradientNorm norm = GradientNorm::kL2)
+      : gaussian_(gaussian), threshold_(threshold), norm_(norm) {}
+
+  /**
+   * @brief Calculate the gradient magnitude of the filtered source
+   *
+   * @param mat       the source values
+   * @param magnitude the destination with the same size as the source, it
+   *                  must not overlap the source
+   */
+  void Apply(Mat2DView<const uint8_t> mat, Mat2DView<uint8_t> magnitude) const;
+
+  /**
+   * @brief Calculate a range of rows of the gradient magnitude of the filtered
+   * source. The neighbouring rows are read from the whole source, so the rows
+   * are identical to those calculated by Apply.
+   *
+   * @param mat       the source values
+   * @param row_begin the first row to calculate
+   * @param row_end   the row after the last row to calculate
+   * @param magnitude the destination of the rows, the first row of the
+   *                  destination receives row_begin
+   */
+  void ApplyRows(Mat2DView<const uint8_t> mat, int row_begin, int row_end,
+                 Mat2DView<uint8_t> magnitude) const;
+
+ private:
+  const FixedPointKernel gaussian_;
+  const Threshold<uint8_t> threshold_;
+  const GradientNorm norm_;
+};
+
+}  // namespace mat
+}  // namespace video_detect
+
+#endif  // VIDEO_DETECT_INCLUDE_VIDEO_DETECT_MAT_EDGE_PIPELINE_H_
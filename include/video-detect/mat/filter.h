@@ -5,10 +5,14 @@
 #ifndef VIDEO_DETECT_INCLUDE_VIDEO_DETECT_MAT_FILTER_H_
 #define VIDEO_DETECT_INCLUDE_VIDEO_DETECT_MAT_FILTER_H_
 
+#include <functional>
 #include <utility>
 
+#include "video-detect/mat/border.h"
 #include "video-detect/mat/conv.h"
+#include "video-detect/mat/kernel.h"
 #include "video-detect/mat/mat_2d.h"
+#include "video-detect/mat/mat_2d_view.h"
 
 namespace video_detect {
 namespace mat {
@@ -16,7 +20,9 @@ namespace mat {
 /**
  * @brief The Filter class uses a predefined filter Kernel and convolutes it
  * with a received matrix. The resultant matrix is passed on to the next
- * handler.
+ * handler. Separable (rank 1) kernels are detected on construction and
+ * applied as a row and a column pass. Filters constructed from a fixed size
+ * Kernel use the unrolled convolutions.
  *
  * @tparam MatType the type of the 2D matrix
  * @tparam KernelType the type of Kernel (defaulted to the same as the matrix)
@@ -29,8 +35,61 @@ class Filter {
    *
    * @param kernel a 2D matrix with the Kernel to use on matrices during
    *               filtering
+   * @param border the treatment of values outside the filtered matrices
    */
-  explicit Filter(const mat::Mat2D<KernelType> &kernel) : kernel_(kernel) {}
+  explicit Filter(const mat::Mat2D<KernelType> &kernel,
+                  BorderMode border = BorderMode::kZero)
+      : border_(border) {
+    Mat2D<KernelType> row_kernel(0, 0);
+    Mat2D<KernelType> col_kernel(0, 0);
+    if (FactorizeKernel(kernel, row_kernel, col_kernel)) {
+      SetSeparable(std::move(row_kernel), std::move(col_kernel));
+    } else {
+      SetFull(kernel);
+    }
+  }
+
+  /**
+   * @brief Construct a new Filter object from a fixed size kernel
+   *
+   * @param kernel the Kernel to use on matrices during filtering
+   * @param border the treatment of values outside the filtered matrices
+   */
+  template <int Rows, int Cols>
+  explicit Filter(const Kernel<KernelType, Rows, Cols> &kernel,
+                  BorderMode border = BorderMode::kZero)
+      : border_(border) {
+    Mat2D<KernelType> row_kernel(0, 0);
+    Mat2D<KernelType> col_kernel(0, 0);
+    if (FactorizeKernel(kernel, row_kernel, col_kernel)) {
+      // Keep the factors at their fixed size
+      Kernel<KernelType, 1, Cols> row{};
+      Kernel<KernelType, Rows, 1> col{};
+      for (int x = 0; x < Cols; x++) {
+        row.values[0][x] = row_kernel.At(0, x);
+      }
+      for (int y = 0; y < Rows; y++) {
+        col.values[y][0] = col_kernel.At(y, 0);
+      }
+      SetSeparable(row, col);
+    } else {
+      SetFull(kernel);
+    }
+  }
+
+  /**
+   * @brief Construct a new Filter object from a separable kernel
+   *
+   * @param row_kernel the horizontal kernel, a single row
+   * @param col_kernel the vertical kernel, a single column
+   * @param border     the treatment of values outside the filtered matrices
+   */
+  Filter(const mat::Mat2D<KernelType> &row_kernel,
+         const mat::Mat2D<KernelType> &col_kernel,
+         BorderMode border = BorderMode::kZero)
+      : border_(border) {
+    SetSeparable(row_kernel, col_kernel);
+  }
 
   /**
    * @brief Apply the filter as setup in the constructor
@@ -39,11 +98,59 @@ class Filter {
    * @return Mat2D<MatType> the filtered 2D matrix
    */
   Mat2D<MatType> Apply(const Mat2D<MatType> &mat) {
-    return ConvMat2D(mat, kernel_);
+    Mat2D<MatType> result(mat.GetRowCount(), mat.GetColCount());
+    Apply(mat.View(), result.View());
+    return result;
+  }
+
+  /**
+   * @brief Apply the filter on the source values into the result
+   *
+   * @param mat    the source values
+   * @param result the destination with the same size as the source
+   */
+  void Apply(Mat2DView<const MatType> mat, Mat2DView<MatType> result) {
+    apply_(mat, result);
   }
 
+  /**
+   * @brief Check if the filter is applied as a row and a column pass
+   */
+  bool IsSeparable() const { return is_separable_; }
+
  private:
-  const mat::Mat2D<KernelType> &kernel_;
+  typedef std::function<void(Mat2DView<const MatType>, Mat2DView<MatType>)>
+      ApplyFunction;
+
+  ApplyFunction apply_;
+  const BorderMode border_;
+  bool is_separable_ = false;
+
+  /**
+   * Apply the kernel as a whole, the kernel is held by value
+   */
+  template <typename KernelMat>
+  void SetFull(KernelMat kernel) {
+    const BorderMode kBorder = border_;
+    apply_ = [kernel, kBorder](Mat2DView<const MatType> mat,
+                               Mat2DView<MatType> result) {
+      ConvMat2D<MatType>(mat, kernel, result, kBorder);
+    };
+    is_separable_ = false;
+  }
+
+  /**
+   * Apply the kernel as a row and a column pass, the factors are held by value
+   */
+  template <typename RowKernel, typename ColKernel>
+  void SetSeparable(RowKernel row_kernel, ColKernel col_kernel) {
+    const BorderMode kBorder = border_;
+    apply_ = [row_kernel, col_kernel, kBorder](Mat2DView<const MatType> mat,
+                                               Mat2DView<MatType> result) {
+      SepConvMat2D<MatType>(mat, row_kernel, col_kernel, result, kBorder);
+    };
+    is_separable_ = true;
+  }
 };
 
 }  // namespace mat
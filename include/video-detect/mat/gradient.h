@@ -0,0 +1,74 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#ifndef VIDEO_DETECT_INCLUDE_VIDEO_DETECT_MAT_GRADIENT_H_
+#define VIDEO_DETECT_INCLUDE_VIDEO_DETECT_MAT_GRADIENT_H_
+
+#include <cstdint>
+
+#include "video-detect/mat/mat_2d_view.h"
+
+namespace video_detect {
+namespace mat {
+
+/**
+ * The norm used to combine the horizontal and vertical gradients
+ */
+enum class GradientNorm {
+  kL1,  // |Gx| + |Gy|
+  kL2   // sqrt(Gx² + Gy²), rounded down
+};
+
+/**
+ * @brief Calculate the Sobel gradient magnitude of a uint8 matrix in a single
+ * pass. Every 3x3 neighbourhood is read once to calculate both the horizontal
+ * (kSobelX3x3) and the vertical (kSobelY3x3) gradient in int16. The magnitude
+ * is saturated to the uint8 range. Values outside the source are treated as
+ * zero.
+ *
+ * @param mat       the source values
+ * @param magnitude the destination of the magnitude, must have the same size
+ *                  as the source and must not overlap it
+ * @param norm      the norm of the magnitude
+ */
+void SobelGradient(Mat2DView<const uint8_t> mat, Mat2DView<uint8_t> magnitude,
+                   GradientNorm norm = GradientNorm::kL2);
+
+/**
+ * @brief Calculate the Sobel gradient magnitude and direction of a uint8
+ * matrix in a single pass
+ *
+ * @param mat       the source values
+ * @param magnitude the destination of the magnitude
+ * @param direction the destination of the direction, counter-clockwise from
+ *                  the positive x-axis with y pointing up in units of
+ *                  360 / 256 degrees, ignored if empty
+ * @param norm      the norm of the magnitude
+ */
+void SobelGradient(Mat2DView<const uint8_t> mat, Mat2DView<uint8_t> magnitude,
+                   Mat2DView<uint8_t> direction,
+                   GradientNorm norm = GradientNorm::kL2);
+
+/**
+ * @brief Calculate the Sobel gradient magnitude and direction of a single row
+ * from the rows above, at and below it. This allows the rows to be streamed
+ * through a small rolling buffer instead of a whole matrix.
+ *
+ * @param above     the row above, or nullptr if it is outside the source
+ * @param center    the row to calculate the gradient of
+ * @param below     the row below, or nullptr if it is outside the source
+ * @param cols      the amount of columns of the rows
+ * @param magnitude the destination row of the magnitude
+ * @param direction the destination row of the direction, or nullptr
+ * @param norm      the norm of the magnitude
+ */
+void SobelGradientRow(const uint8_t *above, const uint8_t *center,
+                      const uint8_t *below, int cols, uint8_t *magnitude,
+                      uint8_t *direction,
+                      GradientNorm norm = GradientNorm::kL2);
+
+}  // namespace mat
+}  // namespace video_detect
+
+#endif  // VIDEO_DETECT_INCLUDE_VIDEO_DETECT_MAT_GRADIENT_H_
@@ -0,0 +1,58 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#ifndef VIDEO_DETECT_INCLUDE_VIDEO_DETECT_MAT_KERNEL_H_
+#define VIDEO_DETECT_INCLUDE_VIDEO_DETECT_MAT_KERNEL_H_
+
+#include "video-detect/mat/mat_2d.h"
+
+namespace video_detect {
+namespace mat {
+
+/**
+ * The Kernel struct is a fixed size 2D kernel that can be defined as a
+ * constexpr constant. It needs no heap allocation and the convolutions with a
+ * Kernel know the amount of taps at compile time, so their loops are unrolled.
+ * A Kernel converts to a Mat2D where a run-time sized kernel is expected.
+ *
+ * @tparam T the type of the kernel values
+ * @tparam Rows the amount of rows (y)
+ * @tparam Cols the amount of columns (x)
+ */
+template <typename T, int Rows, int Cols>
+struct Kernel {
+  static_assert(Rows > 0 && Cols > 0, "A kernel needs at least one value");
+
+  typedef T ValueType;
+
+  T values[Rows][Cols];
+
+  static constexpr int GetRowCount() { return Rows; }
+  static constexpr int GetColCount() { return Cols; }
+
+  /**
+   * Get the value of the kernel at the specified coordinate
+   */
+  constexpr T At(int row, int col) const { return values[row][col]; }
+
+  /**
+   * Create a Mat2D holding a copy of the kernel values
+   */
+  Mat2D<T> ToMat2D() const {
+    Mat2D<T> result(Rows, Cols);
+    for (int row = 0; row < Rows; row++) {
+      for (int col = 0; col < Cols; col++) {
+        result.At(row, col) = values[row][col];
+      }
+    }
+    return result;
+  }
+
+  operator Mat2D<T>() const { return ToMat2D(); }  // NOLINT(runtime/explicit)
+};
+
+}  // namespace mat
+}  // namespace video_detect
+
+#endif  // VIDEO_DETECT_INCLUDE_VIDEO_DETECT_MAT_KERNEL_H_
@@ -5,28 +5,55 @@
 #ifndef VIDEO_DETECT_INCLUDE_VIDEO_DETECT_MAT_KERNEL_DEFS_H_
 #define VIDEO_DETECT_INCLUDE_VIDEO_DETECT_MAT_KERNEL_DEFS_H_
 
-#include "video-detect/mat/mat_2d.h"
+#include <cstdint>
+
+#include "video-detect/mat/kernel.h"
 
 namespace video_detect {
 namespace mat {
 
 constexpr int k3x3 = 24;
-static const Mat2D<float> kKernelGaussian3x3{
+constexpr Kernel<float, 3, 3> kKernelGaussian3x3{
     {{1.f / k3x3, 2.f / k3x3, 1.f / k3x3},
      {2.f / k3x3, 4.f / k3x3, 2.f / k3x3},
      {1.f / k3x3, 2.f / k3x3, 1.f / k3x3}}};
 
 constexpr int k5x5 = 273;
-static const Mat2D<float> kKernelGaussian5x5{
+constexpr Kernel<float, 5, 5> kKernelGaussian5x5{
     {{1.f / k5x5, 4.f / k5x5, 7.f / k5x5, 4.f / k5x5, 1.f / k5x5},
      {4.f / k5x5, 16.f / k5x5, 26.f / k5x5, 16.f / k5x5, 4.f / k5x5},
      {7.f / k5x5, 26.f / k5x5, 41.f / k5x5, 26.f / k5x5, 7.f / k5x5},
      {4.f / k5x5, 16.f / k5x5, 26.f / k5x5, 16.f / k5x5, 4.f / k5x5},
      {1.f / k5x5, 4.f / k5x5, 7.f / k5x5, 4.f / k5x5, 1.f / k5x5}}};
 
-static const Mat2D<int8_t> kSobelX3x3{{{-1, 0, 1}, {-2, 0, 2}, {-1, 0, 1}}};
+constexpr Kernel<int8_t, 3, 3> kSobelX3x3{
+    {{-1, 0, 1}, {-2, 0, 2}, {-1, 0, 1}}};
+
+constexpr Kernel<int8_t, 3, 3> kSobelY3x3{
+    {{1, 2, 1}, {0, 0, 0}, {-1, -2, -1}}};
+
+//
+// Separable kernels, the outer product of the column kernel and the row kernel
+// gives the full kernel
+//
+
+constexpr Kernel<float, 1, 3> kKernelGaussian3x3Row{
+    {{1.f / k3x3, 2.f / k3x3, 1.f / k3x3}}};
+constexpr Kernel<float, 3, 1> kKernelGaussian3x3Col{{{1.f}, {2.f}, {1.f}}};
+
+// The 5x5 kernel above is not separable, this is its binomial counterpart
+constexpr int k5x5Binomial = 256;
+constexpr Kernel<float, 1, 5> kKernelGaussian5x5Row{
+    {{1.f / k5x5Binomial, 4.f / k5x5Binomial, 6.f / k5x5Binomial,
+      4.f / k5x5Binomial, 1.f / k5x5Binomial}}};
+constexpr Kernel<float, 5, 1> kKernelGaussian5x5Col{
+    {{1.f}, {4.f}, {6.f}, {4.f}, {1.f}}};
+
+constexpr Kernel<int8_t, 1, 3> kSobelX3x3Row{{{-1, 0, 1}}};
+constexpr Kernel<int8_t, 3, 1> kSobelX3x3Col{{{1}, {2}, {1}}};
 
-static const Mat2D<int8_t> kSobelY3x3{{{1, 2, 1}, {0, 0, 0}, {-1, -2, -1}}};
+constexpr Kernel<int8_t, 1, 3> kSobelY3x3Row{{{1, 2, 1}}};
+constexpr Kernel<int8_t, 3, 1> kSobelY3x3Col{{{1}, {0}, {-1}}};
 
 }  // namespace mat
 }  // namespace video_detect
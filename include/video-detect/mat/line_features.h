@@ -0,0 +1,99 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#ifndef VIDEO_DETECT_INCLUDE_VIDEO_DETECT_MAT_LINE_FEATURES_H_
+#define VIDEO_DETECT_INCLUDE_VIDEO_DETECT_MAT_LINE_FEATURES_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "video-detect/mat/mat_2d_view.h"
+
+namespace video_detect {
+namespace mat {
+
+/**
+ * A horizontal or vertical line segment
+ */
+struct LineSegment {
+  int row;     // the row of the first pixel
+  int col;     // the column of the first pixel
+  int length;  // the amount of pixels along the line
+};
+
+/**
+ * The LineFeatureFinder class finds the horizontal and vertical runs of 255
+ * values of at least a minimum length. The pixels of a run and the pixel
+ * terminating it are marked in a mask and listed as a segment. Runs which
+ * reach the end of a row or a column are not terminated and are ignored.
+ *
+ * The rows are run-length scanned for the horizontal lines. For the vertical
+ * lines the run length of every column is accumulated while sweeping the rows,
+ * so both directions read the source row by row in a single pass.
+ */
+class LineFeatureFinder {
+ public:
+  /**
+   * @brief Construct a new LineFeatureFinder object
+   *
+   * @param min_length_h the minimum length of a horizontal run, at least 1
+   * @param min_length_v the minimum length of a vertical run, at least 1
+   */
+  LineFeatureFinder(int min_length_h, int min_length_v)
+      : min_length_h_(min_length_h), min_length_v_(min_length_v) {}
+
+  /**
+   * @brief Find the line features of a matrix, replacing the segments found
+   * previously
+   *
+   * @param mat  the source values, only 255 values are part of a line
+   * @param mask the destination with the same size as the source, the pixels
+   *             of the segments are set to 255 and all others to 0. It must
+   *             not overlap the source.
+   */
+  void Apply(Mat2DView<const uint8_t> mat, Mat2DView<uint8_t> mask);
+
+  const std::vector<LineSegment> &GetHorizontalLines() const {
+    return horizontal_lines_;
+  }
+  const std::vector<LineSegment> &GetVerticalLines() const {
+    return vertical_lines_;
+  }
+
+ private:
+  const int min_length_h_;
+  const int min_length_v_;
+  std::vector<LineSegment> horizontal_lines_;
+  std::vector<LineSegment> vertical_lines_;
+  std::vector<int> column_runs_;  // the current vertical run of every column
+
+  void FindHorizontalLines(const uint8_t *src, int row, int cols,
+                           uint8_t *dst);
+  void FindVerticalLines(const uint8_t *src, int row, int cols,
+                         Mat2DView<uint8_t> mask);
+};
+
+/**
+ * @brief Mark the pixels where a horizontal and a vertical line cross. A pixel
+ * is on a horizontal line if at least min_count of the values in its row
+ * within the radius (2 * radius + 1 values centred on it) are 255, and on a
+ * vertical line likewise in its column. Values outside the source count as 0.
+ *
+ * The counts are running sums over the row and, per column, over the rows, so
+ * the cost does not depend on the radius. Bands of rows run in parallel.
+ *
+ * @param mat       the source values, only 255 values are part of a line
+ * @param radius    the amount of values on either side of the pixel
+ * @param min_count the minimum amount of 255 values in both directions
+ * @param result    the destination with the same size as the source, the
+ *                  crossings are set to 255 and all others to 0. It must not
+ *                  overlap the source.
+ */
+void FindLineCrossings(Mat2DView<const uint8_t> mat, int radius,
+                       int min_count, Mat2DView<uint8_t> result);
+
+}  // namespace mat
+}  // namespace video_detect
+
+#endif  // VIDEO_DETECT_INCLUDE_VIDEO_DETECT_MAT_LINE_FEATURES_H_
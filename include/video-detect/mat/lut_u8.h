@@ -0,0 +1,59 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#ifndef VIDEO_DETECT_INCLUDE_VIDEO_DETECT_MAT_LUT_U8_H_
+#define VIDEO_DETECT_INCLUDE_VIDEO_DETECT_MAT_LUT_U8_H_
+
+#include <array>
+#include <cstdint>
+
+#include "video-detect/mat/mat_2d_view.h"
+
+namespace video_detect {
+namespace mat {
+
+/**
+ * A lookup table holding the new value for every uint8 value
+ */
+typedef std::array<uint8_t, 256> LutU8;
+
+/**
+ * The implementations of the lookup
+ */
+enum class LutPath { kScalar, kSsse3, kAvx2 };
+
+/**
+ * @brief Check whether the CPU the program runs on supports the path
+ */
+bool IsLutPathSupported(LutPath path);
+
+/**
+ * @brief Get the fastest path supported by the CPU, it is selected once
+ */
+LutPath GetDefaultLutPath();
+
+/**
+ * @brief Replace every value by its entry in the lookup table in a single
+ * pass using the fastest path supported by the CPU. All paths give identical
+ * results.
+ *
+ * @param mat    the source values
+ * @param lut    the lookup table
+ * @param result the destination with the same size as the source, it may be
+ *               the same as the source
+ */
+void ApplyLutU8(Mat2DView<const uint8_t> mat, const LutU8 &lut,
+                Mat2DView<uint8_t> result);
+
+/**
+ * @brief Replace every value by its entry in the lookup table using the
+ * specified path, which must be supported by the CPU
+ */
+void ApplyLutU8(Mat2DView<const uint8_t> mat, const LutU8 &lut,
+                Mat2DView<uint8_t> result, LutPath path);
+
+}  // namespace mat
+}  // namespace video_detect
+
+#endif  // VIDEO_DETECT_INCLUDE_VIDEO_DETECT_MAT_LUT_U8_H_
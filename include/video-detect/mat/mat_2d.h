@@ -5,31 +5,58 @@
 #ifndef VIDEO_DETECT_INCLUDE_VIDEO_DETECT_MAT_MAT_2D_H_
 #define VIDEO_DETECT_INCLUDE_VIDEO_DETECT_MAT_MAT_2D_H_
 
+#include <algorithm>
 #include <cmath>
+#include <cstddef>
 #include <initializer_list>
+#include <memory>
 #include <ostream>
+#include <string>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
+#include "video-detect/mat/aligned_allocator.h"
+#include "video-detect/mat/mat_expr.h"
+#include "video-detect/mat/mat_2d_view.h"
 #include "video-detect/mat/vector_2d.h"
 
-
 namespace video_detect {
 namespace mat {
 
 /**
- * The Mat2D class represents a 2D templated vector for use as a matrix
+ * The Mat2D class represents a 2D templated matrix. The values are stored in a
+ * single contiguous buffer, row after row, where each row starts at an aligned
+ * offset. The distance between the starts of two rows is the stride.
+ *
+ * A Mat2D either owns its buffer or wraps an existing buffer which is kept
+ * alive by a shared owner. Copies are always deep copies into an owned buffer.
+ *
+ * Element-wise operations (+, *, /, Sqrt, Atan2, ToDegrees, Normalize and
+ * CastTo) are provided by MatExpr and are evaluated lazily, in a single pass,
+ * when the resulting expression is assigned to a Mat2D.
  */
 template <typename T>
-class Mat2D {
+class Mat2D : public MatExpr<Mat2D<T>> {
  public:
+  typedef T ValueType;
+  static constexpr bool kHeldByReference = true;
+  static constexpr bool kIsLeaf = true;
+
   /**
    * A Mat2D constructor using a 2D brace-enclosed initializer list
    *
    * @example Mat2D<int> matrix{{0, 1}, {1, 0}};
    */
-  explicit Mat2D(Vector2D<T> &&matrix) : matrix_(std::move(matrix)) {}
+  explicit Mat2D(Vector2D<T> &&matrix)
+      : Mat2D(static_cast<int>(matrix.size()),
+              matrix.empty() ? 0 : static_cast<int>(matrix.front().size())) {
+    for (int row = 0; row < rows_; row++) {
+      const int kCols = std::min(cols_, static_cast<int>(matrix[row].size()));
+      std::copy(matrix[row].begin(), matrix[row].begin() + kCols,
+                GetRowPtr(row));
+    }
+  }
 
   /**
    * @brief Construct a new Mat 2D object by size
@@ -39,16 +66,93 @@ class Mat2D {
    */
   explicit Mat2D(int rows, int cols) { Resize(rows, cols); }
 
+  /**
+   * @brief Construct a new Mat 2D object on existing storage without copying
+   *
+   * @param data   a pointer to the first value of the first row
+   * @param rows   the amount of rows (y)
+   * @param cols   the amount of colums (x)
+   * @param stride the amount of values between the starts of two rows
+   * @param owner  keeps the storage alive for as long as this matrix refers to
+   *               it, may be empty if the caller guarantees the lifetime
+   */
+  Mat2D(T *data, int rows, int cols, int stride, std::shared_ptr<void> owner)
+      : owner_(std::move(owner)),
+        data_(data),
+        rows_(rows),
+        cols_(cols),
+        stride_(stride) {}
+
+  Mat2D(const Mat2D<T> &other) : Mat2D(other.View()) {}
+
+  Mat2D(Mat2D<T> &&other) noexcept { Swap(other); }
+
+  Mat2D<T> &operator=(const Mat2D<T> &other) {
+    if (this != &other) {
+      Mat2D<T> copy(other);
+      Swap(copy);
+    }
+    return *this;
+  }
+
+  Mat2D<T> &operator=(Mat2D<T> &&other) noexcept {
+    Mat2D<T> moved(std::move(other));
+    Swap(moved);
+    return *this;
+  }
+
+  /**
+   * @brief Construct a new Mat 2D object by evaluating an element-wise
+   * expression in a single pass
+   *
+   * @param expr the expression, e.g. ((x * x) + (y * y)).Sqrt()
+   */
+  template <typename E,
+            typename = std::enable_if_t<internal::IsNodeOf<E, T>::value>>
+  Mat2D(const MatExpr<E> &expr)  // NOLINT(runtime/explicit)
+      : Mat2D(expr.Self().GetRowCount(), expr.Self().GetColCount()) {
+    EvaluateInto(expr, View());
+  }
+
+  /**
+   * @brief Assign an element-wise expression in a single pass, the buffer is
+   * reused if the size is unchanged
+   *
+   * @param expr the expression, e.g. ((x * x) + (y * y)).Sqrt()
+   */
+  template <typename E,
+            typename = std::enable_if_t<internal::IsNodeOf<E, T>::value>>
+  Mat2D<T> &operator=(const MatExpr<E> &expr) {
+    if (data_ != nullptr && expr.Self().HasShape(rows_, cols_)) {
+      EvaluateInto(expr, View());
+    } else {
+      Mat2D<T> result(expr);
+      Swap(result);
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Construct a new Mat 2D object holding a copy of the viewed values
+   *
+   * @param view the values to copy
+   */
+  explicit Mat2D(Mat2DView<const T> view)
+      : Mat2D(view.GetRowCount(), view.GetColCount()) {
+    for (int row = 0; row < rows_; row++) {
+      std::copy(view.GetRowPtr(row), view.GetRowPtr(row) + cols_,
+                GetRowPtr(row));
+    }
+  }
+
   /**
    *  Get the value of the Mat2D at the specified coordinate
    *  @param row the row / y-axis coordinate
    *  @param col the column / x-axis coordinate
    */
   T GetValue(int row, int col) const {
-    if (row < matrix_.size()) {
-      if (col < matrix_.at(row).size()) {
-        return matrix_.at(row).at(col);
-      }
+    if (IsInBounds(row, col)) {
+      return At(row, col);
     }
     // Return empty value for an out of range request
     return T();
@@ -61,226 +165,137 @@ class Mat2D {
    *  @param value the new value to set
    */
   T SetValue(int row, int col, T value) {
-    if (row < matrix_.size()) {
-      if (col < matrix_.at(row).size()) {
-        matrix_.at(row).at(col) = value;
-      }
+    if (IsInBounds(row, col)) {
+      At(row, col) = value;
     }
     // Return empty value for an out of range request
     return T();
   }
 
   /**
-   * Get the Row count
+   * Get a reference to the value at the specified coordinate without any
+   * bounds checking. Intended for hot loops which already know their bounds.
    */
-  int GetRowCount() const { return matrix_.size(); }
+  T &At(int row, int col) { return data_[row * stride_ + col]; }
+  const T &At(int row, int col) const { return data_[row * stride_ + col]; }
 
   /**
-   * Get the Column count
+   * Get the value at the specified coordinate as part of an expression
    */
-  int GetColCount() const {
-    if (!matrix_.empty()) {
-      return matrix_.front().size();
-    } else {
-      return 0;
-    }
-  }
+  T Eval(int row, int col) const { return At(row, col); }
 
   /**
-   * Get the sum of the contents (only if it is arithmetic)
+   * Get a pointer to the first value of the specified row. The row holds
+   * GetColCount() valid values.
    */
-  template <typename Q = T,
-            typename = std::enable_if_t<std::is_arithmetic<Q>::value>>
-  Q GetSumOfContents() const {
-    Q sum = Q();
-    for (const auto &row : matrix_) {
-      for (const auto &col : row) {
-        sum += col;
-      }
-    }
-    return sum;
-  }
+  T *GetRowPtr(int row) { return data_ + row * stride_; }
+  const T *GetRowPtr(int row) const { return data_ + row * stride_; }
 
   /**
-   * @brief Resize the matrix
-   *
-   * @param rows the new row count
-   * @param cols the new column count
+   * Get a non-owning view onto all the values of this matrix
    */
-  void Resize(int rows, int cols) {
-    // Resize the Vector2D
-    matrix_.resize(rows);
-    for (auto &row : matrix_) {
-      row.resize(cols);
-    }
+  Mat2DView<T> View() {
+    return Mat2DView<T>(GetRowPtr(0), rows_, cols_, stride_);
+  }
+  Mat2DView<const T> View() const {
+    return Mat2DView<const T>(GetRowPtr(0), rows_, cols_, stride_);
   }
 
   /**
-   * @brief Calculate the sum of the matrices at each index
-   *
-   * @param other the other matrix to sum with this one
-   * @return Mat2D<T> the resultant matrix with same size as this matrix
+   * Allow a matrix to be passed wherever a view is expected
    */
-  Mat2D<T> operator+(const Mat2D<T> &other) const {
-    Mat2D<T> result(GetRowCount(), GetColCount());
-    for (int row = 0; row < GetRowCount(); row++) {
-      for (int col = 0; col < GetColCount(); col++) {
-        // Sum the contents at the position
-        result.SetValue(row, col,
-                        GetValue(row, col) + other.GetValue(row, col));
-      }
-    }
-    return result;
-  }
+  operator Mat2DView<T>() { return View(); }
+  operator Mat2DView<const T>() const { return View(); }
 
   /**
-   * @brief Calculate the multiplication of the matrices at each index
-   *
-   * @param other the other matrix to multiply with this one
-   * @return Mat2D<T> the resultant matrix with same size as this matrix
+   * Get the Row count
    */
-  Mat2D<T> operator*(const Mat2D<T> &other) const {
-    Mat2D<T> result(GetRowCount(), GetColCount());
-    for (int row = 0; row < GetRowCount(); row++) {
-      for (int col = 0; col < GetColCount(); col++) {
-        // Multiply the contents at the position
-        result.SetValue(row, col,
-                        GetValue(row, col) * other.GetValue(row, col));
-      }
-    }
-    return result;
-  }
+  int GetRowCount() const { return rows_; }
 
   /**
-   * @brief Calculate the division of the matrices at each index
-   *
-   * @param other the other matrix to divide this one by
-   * @return Mat2D<T> the resultant matrix with same size as this matrix
+   * Get the Column count
    */
-  Mat2D<T> operator/(const Mat2D<T> &other) const {
-    Mat2D<T> result(GetRowCount(), GetColCount());
-    for (int row = 0; row < GetRowCount(); row++) {
-      for (int col = 0; col < GetColCount(); col++) {
-        T value = other.GetValue(row, col);
-        // Do not divide by zero
-        if (value != 0) {
-          result.SetValue(row, col, GetValue(row, col) / value);
-        }
-      }
-    }
-    return result;
-  }
+  int GetColCount() const { return cols_; }
 
   /**
-   * @brief Calculate the sqrt of the matrix
-   *
-   * @return Mat2D<T> the resultant matrix
+   * Check the size of the matrix
    */
-  Mat2D<T> Sqrt() const {
-    Mat2D<T> result(GetRowCount(), GetColCount());
-    for (int row = 0; row < GetRowCount(); row++) {
-      for (int col = 0; col < GetColCount(); col++) {
-        // sqrt() the contents at the position
-        T value = GetValue(row, col);
-        if (value >= 0) {
-          result.SetValue(row, col, sqrt(value));
-        }
-      }
-    }
-    return result;
+  bool HasShape(int rows, int cols) const {
+    return rows == rows_ && cols == cols_;
   }
 
   /**
-   * @brief Calculate the atan2(y/x) value of the matrix at each index
-   *
-   * @param other the other matrix as the y-parameter for atan2(y,x) i.e.
-   * arctan2(y/x)
-   * @return Mat2D<T> the resultant matrix
+   * Get the stride i.e. the amount of values between the starts of two
+   * consecutive rows
    */
-  Mat2D<T> Atan2(const Mat2D<T> &other) const {
-    Mat2D<T> result(GetRowCount(), GetColCount());
-    for (int row = 0; row < GetRowCount(); row++) {
-      for (int col = 0; col < GetColCount(); col++) {
-        // atan2(y,x) the contents at the position
-        T x_value = GetValue(row, col);
-        T y_value = other.GetValue(row, col);
-        if (x_value != 0 || y_value != 0) {
-          result.SetValue(row, col, static_cast<T>(atan2(y_value, x_value)));
-        }
-      }
-    }
-    return result;
-  }
+  int GetStride() const { return stride_; }
 
   /**
-   * @brief Convert radians to degrees
-   *
-   * @return Mat2D<T> the resultant matrix
+   * Get the stride for the column count, rounded up so that every row starts
+   * on an aligned address
    */
-  Mat2D<T> ToDegrees() const {
-    Mat2D<T> result(GetRowCount(), GetColCount());
-    for (int row = 0; row < GetRowCount(); row++) {
-      for (int col = 0; col < GetColCount(); col++) {
-        // Convert to degrees
-        T value =
-            static_cast<T>((GetValue(row, col) * 1.f) / (2 * M_PI) * (360));
-        // Rotate into range [0;360]
-        while (value < 0 || value > 360) {
-          if (value < 0) {
-            value += 360;
-          } else if (value > 360) {
-            value -= 360;
-          }
-        }
-        result.SetValue(row, col, value);
-      }
+  static int GetAlignedStride(int cols) {
+    if (kMatAlignment % sizeof(T) != 0) {
+      return cols;
     }
-    return result;
+    const int kValuesPerAlignment = kMatAlignment / sizeof(T);
+    return (cols + kValuesPerAlignment - 1) / kValuesPerAlignment *
+           kValuesPerAlignment;
   }
 
   /**
-   * @brief Normalize a matrix at each position
-   *
-   * @param max     the current expected maximum value
-   * @param new_max the new maximum value to normalize to
-   * @return Mat2D<T> the resultant matrix
+   * Get the sum of the contents (only if it is arithmetic)
    */
-  Mat2D<T> Normalize(T max, T new_max) const {
-    Mat2D<T> result(GetRowCount(), GetColCount());
-    for (int row = 0; row < GetRowCount(); row++) {
-      for (int col = 0; col < GetColCount(); col++) {
-        // Normalize the contents at the position
-        T value = GetValue(row, col);
-        T new_value =
-            static_cast<T>(((value * 1.f) / (max * 1.f)) * (new_max * 1.f));
-        result.SetValue(row, col, new_value);
+  template <typename Q = T,
+            typename = std::enable_if_t<std::is_arithmetic<Q>::value>>
+  Q GetSumOfContents() const {
+    Q sum = Q();
+    for (int row = 0; row < rows_; row++) {
+      const T *src = GetRowPtr(row);
+      for (int col = 0; col < cols_; col++) {
+        sum += src[col];
       }
     }
-    return result;
+    return sum;
   }
 
   /**
-   * @brief Change the underlying type to a new Type
+   * @brief Resize the matrix, the values in the overlapping region are kept
+   * and new values are value-initialized
    *
-   * @return Mat2D<T> the resultant matrix with same size as this matrix, but
-   * with different type
+   * @param rows the new row count
+   * @param cols the new column count
    */
-  template <typename NewType>
-  Mat2D<NewType> CastTo() const {
-    Mat2D<NewType> result(GetRowCount(), GetColCount());
-    for (int row = 0; row < GetRowCount(); row++) {
-      for (int col = 0; col < GetColCount(); col++) {
-        // Cast the contents at the position
-        result.SetValue(row, col, static_cast<NewType>(GetValue(row, col)));
-      }
+  void Resize(int rows, int cols) {
+    if (data_ != nullptr && rows == rows_ && cols == cols_) {
+      return;
+    }
+
+    // Allocate a new owned and value-initialized buffer
+    const int stride = GetAlignedStride(cols);
+    const std::size_t kSize = static_cast<std::size_t>(rows) * stride;
+    T *data = AlignedAllocator<T>().allocate(std::max<std::size_t>(kSize, 1));
+    std::uninitialized_fill_n(data, kSize, T());
+    std::shared_ptr<void> owner(data, &Deallocate);
+
+    // Keep the overlapping region
+    const int kRows = std::min(rows, rows_);
+    const int kCols = std::min(cols, cols_);
+    for (int row = 0; row < kRows; row++) {
+      std::copy(GetRowPtr(row), GetRowPtr(row) + kCols, data + row * stride);
     }
-    return result;
+
+    owner_ = std::move(owner);
+    data_ = data;
+    rows_ = rows;
+    cols_ = cols;
+    stride_ = stride;
   }
 
-  friend std::ostream &operator<<(std::ostream &os, const Mat2D<T>& mat) {
-    for (const auto &row : mat.matrix_) {
-      for (const auto &col : row) {
-        os << std::to_string(col) << " ";
+  friend std::ostream &operator<<(std::ostream &os, const Mat2D<T> &mat) {
+    for (int row = 0; row < mat.GetRowCount(); row++) {
+      for (int col = 0; col < mat.GetColCount(); col++) {
+        os << std::to_string(mat.At(row, col)) << " ";
       }
       os << "\n";
     }
@@ -288,7 +303,30 @@ class Mat2D {
   }
 
  private:
-  Vector2D<T> matrix_;
+  static_assert(std::is_trivially_destructible<T>::value,
+                "Mat2D values are not destructed");
+
+  std::shared_ptr<void> owner_;
+  T *data_ = nullptr;
+  int rows_ = 0;
+  int cols_ = 0;
+  int stride_ = 0;
+
+  static void Deallocate(void *data) {
+    AlignedAllocator<T>().deallocate(static_cast<T *>(data), 0);
+  }
+
+  void Swap(Mat2D<T> &other) noexcept {
+    std::swap(owner_, other.owner_);
+    std::swap(data_, other.data_);
+    std::swap(rows_, other.rows_);
+    std::swap(cols_, other.cols_);
+    std::swap(stride_, other.stride_);
+  }
+
+  bool IsInBounds(int row, int col) const {
+    return row >= 0 && col >= 0 && row < rows_ && col < cols_;
+  }
 };
 
 }  // namespace mat
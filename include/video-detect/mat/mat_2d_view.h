@@ -0,0 +1,156 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#ifndef VIDEO_DETECT_INCLUDE_VIDEO_DETECT_MAT_MAT_2D_VIEW_H_
+#define VIDEO_DETECT_INCLUDE_VIDEO_DETECT_MAT_MAT_2D_VIEW_H_
+
+#include <algorithm>
+#include <type_traits>
+
+#include "video-detect/mat/mat_expr.h"
+
+namespace video_detect {
+namespace mat {
+
+/**
+ * The Mat2DView class is a non-owning window onto 2D matrix values stored
+ * row after row with a fixed stride. A view is cheap to copy and is passed by
+ * value. The storage it refers to must outlive the view.
+ *
+ * @tparam T the type of the values, use a const type for a read-only view
+ */
+template <typename T>
+class Mat2DView : public MatExpr<Mat2DView<T>> {
+ public:
+  typedef std::remove_const_t<T> ValueType;
+  static constexpr bool kHeldByReference = false;
+  static constexpr bool kIsLeaf = true;
+
+  /**
+   * @brief Construct an empty view
+   */
+  Mat2DView() = default;
+
+  /**
+   * @brief Construct a new view onto existing storage
+   *
+   * @param data   a pointer to the first value of the first row
+   * @param rows   the amount of rows (y)
+   * @param cols   the amount of columns (x)
+   * @param stride the amount of values between the starts of two rows
+   */
+  Mat2DView(T *data, int rows, int cols, int stride)
+      : data_(data), rows_(rows), cols_(cols), stride_(stride) {}
+
+  /**
+   * @brief Allow a mutable view to be used where a read-only view is expected
+   */
+  template <typename U, typename = std::enable_if_t<
+                            std::is_same<const U, T>::value &&
+                            !std::is_same<U, T>::value>>
+  Mat2DView(const Mat2DView<U> &other)  // NOLINT(runtime/explicit)
+      : Mat2DView(other.GetData(), other.GetRowCount(), other.GetColCount(),
+                  other.GetStride()) {}
+
+  /**
+   *  Get the value of the view at the specified coordinate
+   *  @param row the row / y-axis coordinate
+   *  @param col the column / x-axis coordinate
+   */
+  ValueType GetValue(int row, int col) const {
+    if (IsInBounds(row, col)) {
+      return At(row, col);
+    }
+    // Return empty value for an out of range request
+    return ValueType();
+  }
+
+  /**
+   *  Set the value of the view at the specified coordinate (mutable views only)
+   *  @param row the row / y-axis coordinate
+   *  @param col the column / x-axis coordinate
+   *  @param value the new value to set
+   */
+  template <typename Q = T,
+            typename = std::enable_if_t<!std::is_const<Q>::value>>
+  void SetValue(int row, int col, ValueType value) const {
+    if (IsInBounds(row, col)) {
+      At(row, col) = value;
+    }
+  }
+
+  /**
+   * Get a reference to the value at the specified coordinate without any
+   * bounds checking
+   */
+  T &At(int row, int col) const { return data_[row * stride_ + col]; }
+
+  /**
+   * Get the value at the specified coordinate as part of an expression
+   */
+  ValueType Eval(int row, int col) const { return At(row, col); }
+
+  /**
+   * Get a pointer to the first value of the specified row
+   */
+  T *GetRowPtr(int row) const { return data_ + row * stride_; }
+
+  /**
+   * Get a pointer to the first value of the view
+   */
+  T *GetData() const { return data_; }
+
+  int GetRowCount() const { return rows_; }
+  int GetColCount() const { return cols_; }
+  int GetStride() const { return stride_; }
+  bool IsEmpty() const { return rows_ <= 0 || cols_ <= 0; }
+  bool HasShape(int rows, int cols) const {
+    return rows == rows_ && cols == cols_;
+  }
+
+  /**
+   * @brief Create a view onto a sub-rectangle of this view, no values are
+   * copied. The rectangle is clipped to the bounds of this view.
+   *
+   * @param row  the first row of the sub-rectangle
+   * @param col  the first column of the sub-rectangle
+   * @param rows the amount of rows of the sub-rectangle
+   * @param cols the amount of columns of the sub-rectangle
+   * @return Mat2DView<T> the view onto the sub-rectangle
+   */
+  Mat2DView<T> Slice(int row, int col, int rows, int cols) const {
+    const int kRowBegin = std::max(0, std::min(row, rows_));
+    const int kColBegin = std::max(0, std::min(col, cols_));
+    const int kRowEnd = std::max(kRowBegin, std::min(row + rows, rows_));
+    const int kColEnd = std::max(kColBegin, std::min(col + cols, cols_));
+    return Mat2DView<T>(data_ + kRowBegin * stride_ + kColBegin,
+                        kRowEnd - kRowBegin, kColEnd - kColBegin, stride_);
+  }
+
+  /**
+   * @brief Create a view onto a band of full rows
+   *
+   * @param row  the first row of the band
+   * @param rows the amount of rows in the band
+   * @return Mat2DView<T> the view onto the band
+   */
+  Mat2DView<T> SliceRows(int row, int rows) const {
+    return Slice(row, 0, rows, cols_);
+  }
+
+ private:
+  T *data_ = nullptr;
+  int rows_ = 0;
+  int cols_ = 0;
+  int stride_ = 0;
+
+  bool IsInBounds(int row, int col) const {
+    return row >= 0 && col >= 0 && row < rows_ && col < cols_;
+  }
+};
+
+}  // namespace mat
+}  // namespace video_detect
+
+#endif  // VIDEO_DETECT_INCLUDE_VIDEO_DETECT_MAT_MAT_2D_VIEW_H_
@@ -0,0 +1,434 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#ifndef VIDEO_DETECT_INCLUDE_VIDEO_DETECT_MAT_MAT_EXPR_H_
+#define VIDEO_DETECT_INCLUDE_VIDEO_DETECT_MAT_MAT_EXPR_H_
+
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "video-detect/util/thread_pool.h"
+
+namespace video_detect {
+namespace mat {
+
+/**
+ * The MatExpr class is the (CRTP) base of all element-wise matrix expressions.
+ *
+ * Element-wise operations on matrices, views and expressions do not compute
+ * anything, they build a lightweight expression object instead. The values
+ * are only computed when the expression is assigned to a Mat2D (or evaluated
+ * into a view), in a single pass over the result without any temporaries.
+ *
+ * A matrix used as an lvalue in an expression is referenced and must outlive
+ * the expression, temporary matrices are moved into the expression.
+ *
+ * @tparam Derived the expression type deriving from this class
+ */
+template <typename Derived>
+class MatExpr {
+ public:
+  const Derived &Self() const { return static_cast<const Derived &>(*this); }
+  Derived &&MoveSelf() { return static_cast<Derived &&>(*this); }
+
+  /**
+   * @brief Calculate the sqrt at each index, negative values result in zero
+   */
+  auto Sqrt() const &;
+  auto Sqrt() &&;
+
+  /**
+   * @brief Calculate the atan2(y/x) value at each index
+   *
+   * @param other the other expression as the y-parameter for atan2(y,x)
+   */
+  template <typename Other>
+  auto Atan2(Other &&other) const &;
+  template <typename Other>
+  auto Atan2(Other &&other) &&;
+
+  /**
+   * @brief Convert radians to degrees in the range [0;360]
+   */
+  auto ToDegrees() const &;
+  auto ToDegrees() &&;
+
+  /**
+   * @brief Normalize the value at each index
+   *
+   * @param max     the current expected maximum value
+   * @param new_max the new maximum value to normalize to
+   */
+  template <typename T>
+  auto Normalize(T max, T new_max) const &;
+  template <typename T>
+  auto Normalize(T max, T new_max) &&;
+
+  /**
+   * @brief Change the value type to a new type
+   */
+  template <typename NewType>
+  auto CastTo() const &;
+  template <typename NewType>
+  auto CastTo() &&;
+
+ protected:
+  MatExpr() = default;
+};
+
+namespace internal {
+
+// Find the expression type X of a type deriving from MatExpr<X>
+template <typename X>
+X ExprTypeOf(const MatExpr<X> *);
+
+template <typename E, typename = void>
+struct IsMatExpr : std::false_type {};
+
+template <typename E>
+struct IsMatExpr<E, decltype(ExprTypeOf(std::declval<std::decay_t<E> *>()),
+                             void())> : std::true_type {};
+
+template <typename E>
+using ExprType = decltype(ExprTypeOf(std::declval<std::decay_t<E> *>()));
+
+// The way a child is held by its parent expression: matrices used as lvalues
+// are held by reference, everything else (views, expressions and temporaries)
+// is held by value
+template <typename E>
+using ExprHolder = std::conditional_t<std::is_lvalue_reference<E>::value &&
+                                          ExprType<E>::kHeldByReference,
+                                      const ExprType<E> &, ExprType<E>>;
+
+template <typename E>
+using ExprValue = typename std::decay_t<E>::ValueType;
+
+// Check whether E is an expression node (not a matrix or view) of T values
+template <typename E, typename T>
+using IsNodeOf = std::integral_constant<
+    bool, !E::kIsLeaf && std::is_same<typename E::ValueType, T>::value>;
+
+template <typename E>
+ExprHolder<E &&> Hold(E &&expr) {
+  return static_cast<ExprHolder<E &&>>(std::forward<E>(expr));
+}
+
+}  // namespace internal
+
+/**
+ * The UnaryExpr class applies an operation on each value of its child
+ */
+template <typename Child, typename Op>
+class UnaryExpr : public MatExpr<UnaryExpr<Child, Op>> {
+ public:
+  typedef std::decay_t<decltype(std::declval<Op>()(
+      std::declval<internal::ExprValue<Child>>()))>
+      ValueType;
+  static constexpr bool kHeldByReference = false;
+  static constexpr bool kIsLeaf = false;
+
+  UnaryExpr(Child child, Op op)
+      : child_(std::forward<Child>(child)), op_(op) {}
+
+  int GetRowCount() const { return child_.GetRowCount(); }
+  int GetColCount() const { return child_.GetColCount(); }
+  bool HasShape(int rows, int cols) const {
+    return child_.HasShape(rows, cols);
+  }
+
+  ValueType GetValue(int row, int col) const {
+    if (row < 0 || col < 0 || row >= GetRowCount() || col >= GetColCount()) {
+      return ValueType();
+    }
+    return op_(child_.GetValue(row, col));
+  }
+
+  ValueType Eval(int row, int col) const {
+    return op_(child_.Eval(row, col));
+  }
+
+ private:
+  Child child_;
+  Op op_;
+};
+
+/**
+ * The BinaryExpr class applies an operation on each pair of values of its
+ * children. The shape of the result is the shape of the left child, values
+ * outside the right child are treated as zero.
+ */
+template <typename Left, typename Right, typename Op>
+class BinaryExpr : public MatExpr<BinaryExpr<Left, Right, Op>> {
+ public:
+  static_assert(std::is_same<internal::ExprValue<Left>,
+                             internal::ExprValue<Right>>::value,
+                "Element-wise operations require equal value types");
+
+  typedef std::decay_t<decltype(std::declval<Op>()(
+      std::declval<internal::ExprValue<Left>>(),
+      std::declval<internal::ExprValue<Right>>()))>
+      ValueType;
+  static constexpr bool kHeldByReference = false;
+  static constexpr bool kIsLeaf = false;
+
+  BinaryExpr(Left left, Right right, Op op)
+      : left_(std::forward<Left>(left)),
+        right_(std::forward<Right>(right)),
+        op_(op) {}
+
+  int GetRowCount() const { return left_.GetRowCount(); }
+  int GetColCount() const { return left_.GetColCount(); }
+  bool HasShape(int rows, int cols) const {
+    return left_.HasShape(rows, cols) && right_.HasShape(rows, cols);
+  }
+
+  ValueType GetValue(int row, int col) const {
+    if (row < 0 || col < 0 || row >= GetRowCount() || col >= GetColCount()) {
+      return ValueType();
+    }
+    return op_(left_.GetValue(row, col), right_.GetValue(row, col));
+  }
+
+  ValueType Eval(int row, int col) const {
+    return op_(left_.Eval(row, col), right_.Eval(row, col));
+  }
+
+ private:
+  Left left_;
+  Right right_;
+  Op op_;
+};
+
+/**
+ * The element-wise operations
+ */
+template <typename T>
+struct AddOp {
+  T operator()(T l, T r) const { return static_cast<T>(l + r); }
+};
+
+template <typename T>
+struct MulOp {
+  T operator()(T l, T r) const { return static_cast<T>(l * r); }
+};
+
+template <typename T>
+struct DivOp {
+  // Do not divide by zero
+  T operator()(T l, T r) const {
+    return (r != 0) ? static_cast<T>(l / r) : T();
+  }
+};
+
+template <typename T>
+struct SqrtOp {
+  T operator()(T value) const {
+    return (value >= 0) ? static_cast<T>(std::sqrt(static_cast<double>(value)))
+                        : T();
+  }
+};
+
+template <typename T>
+struct Atan2Op {
+  T operator()(T x_value, T y_value) const {
+    return (x_value != 0 || y_value != 0)
+               ? static_cast<T>(std::atan2(static_cast<double>(y_value),
+                                           static_cast<double>(x_value)))
+               : T();
+  }
+};
+
+template <typename T>
+struct ToDegreesOp {
+  T operator()(T radians) const {
+    // Convert to degrees
+    T value = static_cast<T>((radians * 1.f) / (2 * M_PI) * (360));
+    // Rotate into range [0;360]
+    while (value < 0 || value > 360) {
+      if (value < 0) {
+        value += 360;
+      } else if (value > 360) {
+        value -= 360;
+      }
+    }
+    return value;
+  }
+};
+
+template <typename T>
+struct NormalizeOp {
+  T max;
+  T new_max;
+  T operator()(T value) const {
+    return static_cast<T>(((value * 1.f) / (max * 1.f)) * (new_max * 1.f));
+  }
+};
+
+template <typename From, typename To>
+struct CastOp {
+  To operator()(From value) const { return static_cast<To>(value); }
+};
+
+namespace internal {
+
+template <typename E, typename Op>
+auto MakeUnary(E &&expr, Op op) {
+  return UnaryExpr<ExprHolder<E &&>, Op>(Hold(std::forward<E>(expr)), op);
+}
+
+template <typename L, typename R, typename Op>
+auto MakeBinary(L &&left, R &&right, Op op) {
+  return BinaryExpr<ExprHolder<L &&>, ExprHolder<R &&>, Op>(
+      Hold(std::forward<L>(left)), Hold(std::forward<R>(right)), op);
+}
+
+}  // namespace internal
+
+/**
+ * @brief Calculate the sum of the expressions at each index
+ */
+template <typename L, typename R,
+          typename = std::enable_if_t<internal::IsMatExpr<L>::value &&
+                                      internal::IsMatExpr<R>::value>>
+auto operator+(L &&left, R &&right) {
+  typedef internal::ExprValue<internal::ExprType<L>> V;
+  return internal::MakeBinary(std::forward<L>(left), std::forward<R>(right),
+                              AddOp<V>());
+}
+
+/**
+ * @brief Calculate the multiplication of the expressions at each index
+ */
+template <typename L, typename R,
+          typename = std::enable_if_t<internal::IsMatExpr<L>::value &&
+                                      internal::IsMatExpr<R>::value>>
+auto operator*(L &&left, R &&right) {
+  typedef internal::ExprValue<internal::ExprType<L>> V;
+  return internal::MakeBinary(std::forward<L>(left), std::forward<R>(right),
+                              MulOp<V>());
+}
+
+/**
+ * @brief Calculate the division of the expressions at each index, a division
+ * by zero results in zero
+ */
+template <typename L, typename R,
+          typename = std::enable_if_t<internal::IsMatExpr<L>::value &&
+                                      internal::IsMatExpr<R>::value>>
+auto operator/(L &&left, R &&right) {
+  typedef internal::ExprValue<internal::ExprType<L>> V;
+  return internal::MakeBinary(std::forward<L>(left), std::forward<R>(right),
+                              DivOp<V>());
+}
+
+template <typename Derived>
+auto MatExpr<Derived>::Sqrt() const & {
+  return internal::MakeUnary(Self(),
+                             SqrtOp<internal::ExprValue<Derived>>());
+}
+
+template <typename Derived>
+auto MatExpr<Derived>::Sqrt() && {
+  return internal::MakeUnary(MoveSelf(),
+                             SqrtOp<internal::ExprValue<Derived>>());
+}
+
+template <typename Derived>
+template <typename Other>
+auto MatExpr<Derived>::Atan2(Other &&other) const & {
+  return internal::MakeBinary(Self(), std::forward<Other>(other),
+                              Atan2Op<internal::ExprValue<Derived>>());
+}
+
+template <typename Derived>
+template <typename Other>
+auto MatExpr<Derived>::Atan2(Other &&other) && {
+  return internal::MakeBinary(MoveSelf(), std::forward<Other>(other),
+                              Atan2Op<internal::ExprValue<Derived>>());
+}
+
+template <typename Derived>
+auto MatExpr<Derived>::ToDegrees() const & {
+  return internal::MakeUnary(Self(),
+                             ToDegreesOp<internal::ExprValue<Derived>>());
+}
+
+template <typename Derived>
+auto MatExpr<Derived>::ToDegrees() && {
+  return internal::MakeUnary(MoveSelf(),
+                             ToDegreesOp<internal::ExprValue<Derived>>());
+}
+
+template <typename Derived>
+template <typename T>
+auto MatExpr<Derived>::Normalize(T max, T new_max) const & {
+  typedef internal::ExprValue<Derived> V;
+  return internal::MakeUnary(
+      Self(), NormalizeOp<V>{static_cast<V>(max), static_cast<V>(new_max)});
+}
+
+template <typename Derived>
+template <typename T>
+auto MatExpr<Derived>::Normalize(T max, T new_max) && {
+  typedef internal::ExprValue<Derived> V;
+  return internal::MakeUnary(
+      MoveSelf(), NormalizeOp<V>{static_cast<V>(max), static_cast<V>(new_max)});
+}
+
+template <typename Derived>
+template <typename NewType>
+auto MatExpr<Derived>::CastTo() const & {
+  return internal::MakeUnary(
+      Self(), CastOp<internal::ExprValue<Derived>, NewType>());
+}
+
+template <typename Derived>
+template <typename NewType>
+auto MatExpr<Derived>::CastTo() && {
+  return internal::MakeUnary(
+      MoveSelf(), CastOp<internal::ExprValue<Derived>, NewType>());
+}
+
+/**
+ * @brief Evaluate an expression into a destination in a single pass, bands of
+ * rows are evaluated in parallel
+ *
+ * @param expr   the expression to evaluate
+ * @param result the destination with the same size as the expression, it may
+ *               only overlap the expression's matrices at the same indices
+ */
+template <typename E, typename Result>
+void EvaluateInto(const MatExpr<E> &expr, Result &&result) {
+  const E &kExpr = expr.Self();
+  const int rows = kExpr.GetRowCount();
+  const int cols = kExpr.GetColCount();
+  const bool kSameShape = kExpr.HasShape(rows, cols);
+  const std::size_t kRowBytes = cols * sizeof(internal::ExprValue<E>);
+
+  util::ParallelForRows(rows, kRowBytes, [&](int row_begin, int row_end) {
+    if (kSameShape) {
+      // All the matrices have the same shape, no bounds checks are needed
+      for (int row = row_begin; row < row_end; row++) {
+        auto *dst = result.GetRowPtr(row);
+        for (int col = 0; col < cols; col++) {
+          dst[col] = kExpr.Eval(row, col);
+        }
+      }
+    } else {
+      for (int row = row_begin; row < row_end; row++) {
+        auto *dst = result.GetRowPtr(row);
+        for (int col = 0; col < cols; col++) {
+          dst[col] = kExpr.GetValue(row, col);
+        }
+      }
+    }
+  });
+}
+
+}  // namespace mat
+}  // namespace video_detect
+
+#endif  // VIDEO_DETECT_INCLUDE_VIDEO_DETECT_MAT_MAT_EXPR_H_
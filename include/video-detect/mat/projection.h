@@ -0,0 +1,70 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#ifndef VIDEO_DETECT_INCLUDE_VIDEO_DETECT_MAT_PROJECTION_H_
+#define VIDEO_DETECT_INCLUDE_VIDEO_DETECT_MAT_PROJECTION_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "video-detect/mat/mat_2d_view.h"
+
+namespace video_detect {
+namespace mat {
+
+/**
+ * The implementations of the gradient projections
+ */
+enum class ProjectionPath { kScalar, kAvx2 };
+
+/**
+ * @brief Check whether the CPU the program runs on supports the path
+ */
+bool IsProjectionPathSupported(ProjectionPath path);
+
+/**
+ * @brief Get the fastest path supported by the CPU, it is selected once
+ */
+ProjectionPath GetDefaultProjectionPath();
+
+/**
+ * @brief Calculate the projection profiles of the gradients of a uint8 matrix
+ * in a single pass. The vertical gradient |m(r, c) - m(r - 1, c)| is summed
+ * over every row r and the horizontal gradient |m(r, c) - m(r, c - 1)| over
+ * every column c, so horizontal edges peak in the row profile and vertical
+ * edges in the column profile. The first row and column have no neighbour and
+ * sum to 0. Bands of rows run in parallel.
+ *
+ * @param mat         the source values
+ * @param row_profile the destination of the row sums, resized to the rows
+ * @param col_profile the destination of the column sums, resized to the
+ *                    columns
+ */
+void ProjectGradients(Mat2DView<const uint8_t> mat,
+                      std::vector<uint32_t> *row_profile,
+                      std::vector<uint32_t> *col_profile);
+
+/**
+ * @brief Calculate the row sums of a range of rows and add its column sums
+ * using the specified path, which must be supported by the CPU. The row above
+ * the range is read from the whole source, so the column sums of several
+ * ranges add up to those of ProjectGradients. All paths give identical
+ * results.
+ *
+ * @param mat         the source values
+ * @param row_begin   the first row to project
+ * @param row_end     the row after the last row to project
+ * @param row_profile the destination of the row sums, the first receives
+ *                    row_begin
+ * @param col_profile the column sums to add to, one per column
+ * @param path        the implementation to use
+ */
+void ProjectGradientRows(Mat2DView<const uint8_t> mat, int row_begin,
+                         int row_end, uint32_t *row_profile,
+                         uint32_t *col_profile, ProjectionPath path);
+
+}  // namespace mat
+}  // namespace video_detect
+
+#endif  // VIDEO_DETECT_INCLUDE_VIDEO_DETECT_MAT_PROJECTION_H_
@@ -6,60 +6,158 @@
 #define VIDEO_DETECT_INCLUDE_VIDEO_DETECT_MAT_THRESHOLD_H_
 
 #include <algorithm>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
+#include "video-detect/mat/lut_u8.h"
 #include "video-detect/mat/mat_2d.h"
+#include "video-detect/mat/mat_2d_view.h"
+#include "video-detect/util/thread_pool.h"
 
 namespace video_detect {
 namespace mat {
 
+/**
+ * The Threshold class keeps values inside a set of ranges and replaces the
+ * values outside of them by a minimum or maximum. For uint8 values the mapping
+ * is compiled into a lookup table at construction, which is applied in a
+ * single vectorized pass.
+ */
 template <typename MatType, typename KernelType = MatType>
 class Threshold {
  public:
   explicit Threshold(MatType lower_bound, MatType upper_bound, MatType minimum,
                      MatType maximum)
-      : range_{std::make_pair(std::move(lower_bound), std::move(upper_bound))},
-        minimum_(minimum),
-        maximum_(maximum) {}
+      : Threshold({std::make_pair(std::move(lower_bound),
+                                  std::move(upper_bound))},
+                  minimum, maximum) {}
 
-  Mat2D<MatType> Apply(const Mat2D<MatType> &mat) {
-    Mat2D<MatType> result(mat.GetRowCount(), mat.GetColCount());
+  /**
+   * @brief Construct a threshold with multiple ranges. The ranges are checked
+   * in order, a value inside a range is kept and stops the search. A value
+   * below or above a range becomes the minimum or maximum respectively, unless
+   * a later range keeps it.
+   *
+   * @param ranges  the (lower bound, upper bound) pairs
+   * @param minimum the value for values below a range
+   * @param maximum the value for values above a range
+   */
+  Threshold(std::vector<std::pair<MatType, MatType>> ranges, MatType minimum,
+            MatType maximum)
+      : range_(std::move(ranges)), minimum_(minimum), maximum_(maximum) {
+    BuildLut(std::integral_constant<bool, kUseLut>());
+  }
 
-    // Navigate through the matrix
-    for (int row = 0; row < mat.GetRowCount(); row++) {
-      for (int col = 0; col < mat.GetColCount(); col++) {
-        MatType value = mat.GetValue(row, col);
-        MatType new_value = MatType{};
-        // Check if the value is in the bounds, else set it to min / max of
-        // MatType
-        auto it = range_.begin();
-        bool found_range = false;
-        while (!found_range && it != range_.end()) {
-          // Change the value if it is out of bounds
-          if (value < it->first) {
-            new_value = minimum_;
-
-          } else if (value > it->second) {
-            new_value = maximum_;
-
-          } else {
-            // Set the new_value, it is in bounds and stop the search
-            new_value = mat.GetValue(row, col);
-            found_range = true;
-          }
-          it++;
-        }
-        result.SetValue(row, col, new_value);
-      }
-    }
+  Mat2D<MatType> Apply(const Mat2D<MatType> &mat) const {
+    Mat2D<MatType> result(mat.GetRowCount(), mat.GetColCount());
+    Apply(mat.View(), result.View());
     return result;
   }
 
+  /**
+   * @brief Apply the threshold on the source values into the result
+   *
+   * @param mat    the source values
+   * @param result the destination with the same size as the source, it may be
+   *               the same as the source
+   */
+  void Apply(Mat2DView<const MatType> mat, Mat2DView<MatType> result) const {
+    ApplyValues(mat, result, std::integral_constant<bool, kUseLut>());
+  }
+
+  /**
+   * @brief Apply the threshold in place
+   */
+  void Apply(Mat2DView<MatType> mat) const { Apply(mat, mat); }
+
+  /**
+   * @brief Apply the threshold in place on the calling thread
+   *
+   * Used for rows of a band which already runs on the thread pool, where
+   * dispatching each row again would only add overhead.
+   */
+  void ApplyRows(Mat2DView<MatType> mat) const {
+    ApplyBand(mat, mat, std::integral_constant<bool, kUseLut>());
+  }
+
  private:
+  static constexpr bool kUseLut = std::is_same<MatType, uint8_t>::value;
+
   const std::vector<std::pair<MatType, MatType>> range_;
   const MatType minimum_;
   const MatType maximum_;
+  LutU8 lut_{};
+
+  MatType GetNewValue(MatType value) const {
+    MatType new_value = MatType{};
+    // Check if the value is in the bounds, else set it to min / max of
+    // MatType
+    auto it = range_.begin();
+    bool found_range = false;
+    while (!found_range && it != range_.end()) {
+      // Change the value if it is out of bounds
+      if (value < it->first) {
+        new_value = minimum_;
+
+      } else if (value > it->second) {
+        new_value = maximum_;
+
+      } else {
+        // Set the new_value, it is in bounds and stop the search
+        new_value = value;
+        found_range = true;
+      }
+      it++;
+    }
+    return new_value;
+  }
+
+  void BuildLut(std::true_type) {
+    for (int value = 0; value < static_cast<int>(lut_.size()); value++) {
+      lut_[value] = GetNewValue(static_cast<MatType>(value));
+    }
+  }
+
+  void BuildLut(std::false_type) {}
+
+  void ApplyBand(Mat2DView<const MatType> mat, Mat2DView<MatType> result,
+                 std::true_type) const {
+    ApplyLutU8(mat, lut_, result);
+  }
+
+  void ApplyBand(Mat2DView<const MatType> mat, Mat2DView<MatType> result,
+                 std::false_type) const {
+    for (int row = 0; row < mat.GetRowCount(); row++) {
+      const MatType *src = mat.GetRowPtr(row);
+      MatType *dst = result.GetRowPtr(row);
+      for (int col = 0; col < mat.GetColCount(); col++) {
+        dst[col] = GetNewValue(src[col]);
+      }
+    }
+  }
+
+  void ApplyValues(Mat2DView<const MatType> mat, Mat2DView<MatType> result,
+                   std::true_type) const {
+    util::ParallelForRows(
+        mat.GetRowCount(), mat.GetColCount(), [&](int row_begin, int row_end) {
+          const int kRows = row_end - row_begin;
+          ApplyBand(mat.SliceRows(row_begin, kRows),
+                    result.SliceRows(row_begin, kRows), std::true_type());
+        });
+  }
+
+  void ApplyValues(Mat2DView<const MatType> mat, Mat2DView<MatType> result,
+                   std::false_type) const {
+    // Navigate through the matrix in parallel bands of rows
+    util::ParallelForRows(
+        mat.GetRowCount(), mat.GetColCount() * sizeof(MatType),
+        [&](int row_begin, int row_end) {
+          const int kRows = row_end - row_begin;
+          ApplyBand(mat.SliceRows(row_begin, kRows),
+                    result.SliceRows(row_begin, kRows), std::false_type());
+        });
+  }
 };
 
 }  // namespace mat
@@ -19,7 +19,8 @@ namespace video_detect {
  * code and the cppengineer/video-detect code.
  *
  */
-class MatBridge : public util::ObjectReceiver<const cv::Mat &> {
+class MatBridge : public util::ObjectReceiver<const cv::Mat &>,
+                  public util::ObjectReceiver<mat::Mat2D<uint8_t>> {
  public:
   /**
    * @brief Construct a new Mat Bridge object
@@ -35,10 +36,18 @@ class MatBridge : public util::ObjectReceiver<const cv::Mat &> {
   /**
    * @brief Accept a OpenCV Mat object
    *
-   * @param cv_mat a 3-Channel (RGB) unsigned char opencv matrix
+   * @param cv_mat a 3-Channel (BGR) or a single channel (grayscale) unsigned
+   * char opencv matrix
    */
   void Accept(const cv::Mat &cv_mat) override;
 
+  /**
+   * @brief Accept a grayscale matrix, which is passed on without copying
+   *
+   * @param mat a single channel unsigned char matrix
+   */
+  void Accept(mat::Mat2D<uint8_t> mat) override;
+
  private:
   util::Worker &worker_;
   util::ObjectReceiver<const mat::Mat2D<uint8_t> &> &receiver_;
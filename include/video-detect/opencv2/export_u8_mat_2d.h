@@ -5,9 +5,11 @@
 #ifndef VIDEO_DETECT_INCLUDE_VIDEO_DETECT_OPENCV2_EXPORT_U8_MAT_2D_H_
 #define VIDEO_DETECT_INCLUDE_VIDEO_DETECT_OPENCV2_EXPORT_U8_MAT_2D_H_
 
+#include <atomic>
 #include <string>
 
 #include "video-detect/mat/mat_2d.h"
+#include "video-detect/mat/mat_2d_view.h"
 #include "video-detect/util/object_receiver.h"
 
 namespace video_detect {
@@ -25,8 +27,15 @@ class ExportU8Mat2D : public util::ObjectReceiver<const mat::Mat2D<uint8_t> &> {
 
   void Accept(const mat::Mat2D<uint8_t> &mat) override;
 
+  /**
+   * @brief Export the viewed values as an image without copying them
+   *
+   * @param mat the values to export
+   */
+  void Export(mat::Mat2DView<const uint8_t> mat);
+
  private:
-  static int counter_;
+  static std::atomic<int> counter_;
   const std::string name_;
   const std::string path_;
 };
@@ -5,6 +5,7 @@
 #ifndef VIDEO_DETECT_INCLUDE_VIDEO_DETECT_OPENCV2_MAT_2D_ADAPTER_H_
 #define VIDEO_DETECT_INCLUDE_VIDEO_DETECT_OPENCV2_MAT_2D_ADAPTER_H_
 
+#include <memory>
 #include <utility>
 
 #include <opencv2/core/mat.hpp>
@@ -17,21 +18,38 @@ namespace video_detect {
 namespace opencv2 {
 
 /**
- * @brief The Mat2DAdapter adapts a cv::Mat to a Mat2D class
+ * @brief The Mat2DAdapter adapts a cv::Mat to a Mat2D class.
+ *
+ * If the cv::Mat owns its (reference counted) data and holds values of type T
+ * the Mat2D wraps that data without copying and keeps it alive by holding a
+ * reference to it. Writes through the Mat2D are then visible in the cv::Mat.
+ * Otherwise the values are copied.
  *
  * @tparam T the type of 2D Matrix to use
  */
 template <typename T>
 class Mat2DAdapter : public mat::Mat2D<T> {
  public:
-  explicit Mat2DAdapter(const cv::Mat &mat)
-      : mat::Mat2D<T>(mat.rows, mat.cols) {
-    // Set all the values
+  explicit Mat2DAdapter(const cv::Mat &mat) : mat::Mat2D<T>(Adapt(mat)) {}
+
+ private:
+  static mat::Mat2D<T> Adapt(const cv::Mat &mat) {
+    // Wrap the cv::Mat data, the copied cv::Mat header holds a reference
+    if (mat.u != nullptr && mat.dims == 2 && mat.elemSize() == sizeof(T) &&
+        mat.step[0] % sizeof(T) == 0) {
+      return mat::Mat2D<T>(reinterpret_cast<T *>(mat.data), mat.rows,
+                           mat.cols, static_cast<int>(mat.step[0] / sizeof(T)),
+                           std::make_shared<cv::Mat>(mat));
+    }
+
+    // Copy all the values
+    mat::Mat2D<T> result(mat.rows, mat.cols);
     for (int row = 0; row < mat.rows; row++) {
       for (int col = 0; col < mat.cols; col++) {
-        mat::Mat2D<T>::SetValue(row, col, mat.at<T>(row, col));
+        result.At(row, col) = mat.at<T>(row, col);
       }
     }
+    return result;
   }
 };
 
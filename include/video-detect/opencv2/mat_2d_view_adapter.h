@@ -0,0 +1,44 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#ifndef VIDEO_DETECT_INCLUDE_VIDEO_DETECT_OPENCV2_MAT_2D_VIEW_ADAPTER_H_
+#define VIDEO_DETECT_INCLUDE_VIDEO_DETECT_OPENCV2_MAT_2D_VIEW_ADAPTER_H_
+
+#include <opencv2/core/mat.hpp>
+
+#include "video-detect/mat/mat_2d_view.h"
+
+namespace video_detect {
+namespace opencv2 {
+
+/**
+ * @brief The Mat2DViewAdapter adapts a single channel cv::Mat to a Mat2DView
+ * without copying any values. The cv::Mat must outlive the view. A cv::Mat
+ * with a different element size or a stride which is not a whole amount of
+ * elements results in an empty view.
+ *
+ * @tparam T the type of the view values, use a const type for read-only access
+ */
+template <typename T>
+class Mat2DViewAdapter : public mat::Mat2DView<T> {
+ public:
+  explicit Mat2DViewAdapter(const cv::Mat &mat)
+      : mat::Mat2DView<T>(MakeView(mat)) {}
+
+ private:
+  static mat::Mat2DView<T> MakeView(const cv::Mat &mat) {
+    if (mat.dims != 2 || mat.elemSize() != sizeof(T) ||
+        mat.step[0] % sizeof(T) != 0) {
+      return mat::Mat2DView<T>();
+    }
+    const int kStride = static_cast<int>(mat.step[0] / sizeof(T));
+    return mat::Mat2DView<T>(reinterpret_cast<T *>(mat.data), mat.rows,
+                             mat.cols, kStride);
+  }
+};
+
+}  // namespace opencv2
+}  // namespace video_detect
+
+#endif  // VIDEO_DETECT_INCLUDE_VIDEO_DETECT_OPENCV2_MAT_2D_VIEW_ADAPTER_H_
@@ -9,6 +9,8 @@
 #include <map>
 #include <string>
 
+#include "video-detect/ffmpeg/decoder_settings.h"
+
 namespace video_detect {
 
 /**
@@ -18,6 +20,15 @@ namespace video_detect {
  */
 class Options {
  public:
+  /**
+   * The engines estimating the frame size
+   */
+  enum class Engine {
+    kContour,    // contour, linear feature and corner analysis
+    kProfile,    // projection profiles of the edge strength
+    kHypothesis  // edge strength along the lines of candidate grids
+  };
+
   /**
    * @brief Construct a new Options object
    *
@@ -40,12 +51,33 @@ class Options {
   bool IsExportImages() const;
   const int GetFrameModulo() const;
   const int GetConfidenceLevel() const;
+  const int GetThreadCount() const;
+  const int GetMaxGridSize() const;
+  Engine GetEngine() const;
+  float GetMargin() const;
+  ffmpeg::FrameSkip GetFrameSkip() const;
+  double GetSampleInterval() const;
+  const int GetSampleCount() const;
+  bool IsSampling() const;
+  const int GetDecodeThreadCount() const;
+  ffmpeg::DecodeThreading GetDecodeThreading() const;
+  const int GetSegmentCount() const;
 
  private:
   std::string file_input_;
   std::string output_path_;
   int frame_modulo_;
   int confidence_level_;
+  int thread_count_;
+  int max_grid_size_;
+  Engine engine_;
+  float margin_;
+  ffmpeg::FrameSkip frame_skip_;
+  double sample_interval_;
+  int sample_count_;
+  int decode_thread_count_;
+  ffmpeg::DecodeThreading decode_threading_;
+  int segment_count_;
   const std::map<std::string, std::string> options_;
   std::map<const char *, std::function<void(const std::string &)>>
       option_handlers_;
@@ -60,6 +92,16 @@ class Options {
   void HandleOutputPath(const std::string &value);
   void HandleFrameModulo(const std::string &value);
   void HandleConfidenceLevel(const std::string &value);
+  void HandleThreadCount(const std::string &value);
+  void HandleMaxGridSize(const std::string &value);
+  void HandleEngine(const std::string &value);
+  void HandleMargin(const std::string &value);
+  void HandleFrameSkip(const std::string &value);
+  void HandleSampleInterval(const std::string &value);
+  void HandleSampleCount(const std::string &value);
+  void HandleDecodeThreadCount(const std::string &value);
+  void HandleDecodeThreading(const std::string &value);
+  void HandleSegmentCount(const std::string &value);
   [[noreturn]] void HandleHelp(const std::string &value);
   [[noreturn]] void HandleVersion(const std::string &value);
 };
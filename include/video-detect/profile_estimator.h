@@ -0,0 +1,72 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#ifndef VIDEO_DETECT_INCLUDE_VIDEO_DETECT_PROFILE_ESTIMATOR_H_
+#define VIDEO_DETECT_INCLUDE_VIDEO_DETECT_PROFILE_ESTIMATOR_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "video-detect/grid_estimator.h"
+#include "video-detect/mat/mat_2d.h"
+
+namespace video_detect {
+
+/**
+ * The ProfileEstimator class estimates the frame size of axis-aligned video
+ * grids from projection profiles. The vertical gradients of every row and the
+ * horizontal gradients of every column are summed into two 1-D profiles, whose
+ * peaks are the boundaries of the frames. Every image votes for the amount of
+ * rows and columns of the grid whose boundaries are all peaks.
+ *
+ * The profiles are projected in a single pass over the image without any
+ * intermediate images, which takes a fraction of the work of the filtering,
+ * contour and corner analysis of the FrameSizeEstimator.
+ */
+class ProfileEstimator : public GridEstimator {
+ public:
+  /**
+   * @brief Construct a new ProfileEstimator object
+   *
+   * @param print_votes a boolean flag indicating whether to print the votes
+   * @param confidence_level the amount of images that have to vote for the
+   *                         same grid before it is accepted
+   * @param max_grid_size the maximum amount of frames along the height or the
+   *                      width of the video
+   */
+  ProfileEstimator(bool print_votes, int confidence_level, int max_grid_size);
+
+  /**
+   * @brief The Accept method expects a grayscale image
+   *
+   * @param mat this is a 2D single channel unsigned char matrix
+   */
+  void Accept(const mat::Mat2D<uint8_t> &mat) override;
+
+  /**
+   * @brief Find the largest amount of equal frames along a profile for which
+   * the profile peaks at every boundary between the frames. A boundary peaks
+   * if the maximum of the profile near it is at least kMinPeakRatio times the
+   * mean and kMinPeakFraction times the maximum of the profile, as the
+   * boundaries run along the whole image while the content of a frame does
+   * not.
+   *
+   * @param profile       the row or column sums of the gradients
+   * @param max_grid_size the maximum amount of frames
+   * @return int the amount of frames, 1 if no grid fits
+   */
+  static int FindGridCount(const std::vector<uint32_t> &profile,
+                           int max_grid_size);
+
+  static constexpr float kMinPeakRatio = 2.f;
+  static constexpr float kMinPeakFraction = .5f;
+
+ private:
+  std::vector<uint32_t> row_profile_;
+  std::vector<uint32_t> col_profile_;
+};
+
+}  // namespace video_detect
+
+#endif  // VIDEO_DETECT_INCLUDE_VIDEO_DETECT_PROFILE_ESTIMATOR_H_
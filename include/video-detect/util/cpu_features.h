@@ -0,0 +1,31 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#ifndef VIDEO_DETECT_INCLUDE_VIDEO_DETECT_UTIL_CPU_FEATURES_H_
+#define VIDEO_DETECT_INCLUDE_VIDEO_DETECT_UTIL_CPU_FEATURES_H_
+
+namespace video_detect {
+namespace util {
+
+/**
+ * The CpuFeatures struct holds the instruction set extensions of the CPU the
+ * program runs on that the optimized code paths can make use of
+ */
+struct CpuFeatures {
+  bool sse41 = false;
+  bool ssse3 = false;
+  bool avx2 = false;
+};
+
+/**
+ * @brief Get the features of the CPU, they are detected once on the first call
+ *
+ * @return const CpuFeatures& the detected features
+ */
+const CpuFeatures &GetCpuFeatures();
+
+}  // namespace util
+}  // namespace video_detect
+
+#endif  // VIDEO_DETECT_INCLUDE_VIDEO_DETECT_UTIL_CPU_FEATURES_H_
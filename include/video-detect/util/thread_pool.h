@@ -0,0 +1,120 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#ifndef VIDEO_DETECT_INCLUDE_VIDEO_DETECT_UTIL_THREAD_POOL_H_
+#define VIDEO_DETECT_INCLUDE_VIDEO_DETECT_UTIL_THREAD_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace video_detect {
+namespace util {
+
+/**
+ * The ThreadPool class executes a loop over a range of indices on a fixed set
+ * of threads. The range is split into bands which the threads, including the
+ * calling thread, take one after the other until the range is done.
+ *
+ * A ParallelFor called from inside a band, or while another thread is running
+ * a ParallelFor on the same pool, runs serially on the calling thread.
+ */
+class ThreadPool {
+ public:
+  /**
+   * @brief Construct a new ThreadPool object
+   *
+   * @param thread_count the amount of threads including the calling thread,
+   *                     one or less runs everything on the calling thread
+   */
+  explicit ThreadPool(int thread_count);
+
+  /**
+   * Stop and join the threads
+   */
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  /**
+   * @brief Call the body for bands of the range [begin, end) and return when
+   * all bands are done. The bands do not overlap and cover the range.
+   *
+   * @param begin the first index
+   * @param end   the index after the last index
+   * @param grain the amount of indices in a band
+   * @param body  the function called with the begin and end of a band
+   */
+  void ParallelFor(int begin, int end, int grain,
+                   const std::function<void(int, int)> &body);
+
+  int GetThreadCount() const { return static_cast<int>(threads_.size()) + 1; }
+
+ private:
+  std::vector<std::thread> threads_;
+  std::mutex run_access_;  // held by the thread running a ParallelFor
+  std::mutex state_access_;
+  std::condition_variable work_available_;
+  std::condition_variable work_done_;
+  const std::function<void(int, int)> *body_ = nullptr;
+  std::atomic<int> next_{0};
+  int end_ = 0;
+  int grain_ = 1;
+  int pending_ = 0;
+  unsigned long generation_ = 0;  // NOLINT(runtime/int)
+  bool stop_ = false;
+
+  /**
+   * The DoWork method is the loop of the threads, waiting for a ParallelFor
+   */
+  void DoWork();
+
+  /**
+   * Take and execute bands until the range is done
+   */
+  void RunBands();
+};
+
+/**
+ * @brief Set the amount of threads used by the matrix operations, by default
+ * they run on the calling thread only. This is meant to be called once at
+ * startup, before any matrix operation runs.
+ *
+ * @param thread_count the amount of threads, zero uses one per hardware thread
+ */
+void SetThreadCount(int thread_count);
+
+/**
+ * @brief Get the amount of threads used by the matrix operations
+ */
+int GetThreadCount();
+
+/**
+ * @brief Run a ParallelFor on the thread pool of the matrix operations
+ */
+void ParallelFor(int begin, int end, int grain,
+                 const std::function<void(int, int)> &body);
+
+/**
+ * @brief Run a ParallelFor over the rows of an image in bands which fit in
+ * the cache, but at least one band per thread. Operations reading
+ * neighbouring rows (a halo) must read them from the whole source, only the
+ * destination rows of a band are written by the band.
+ *
+ * @param rows      the amount of rows
+ * @param row_bytes the amount of bytes touched per row
+ * @param body      the function called with the first and last + 1 row
+ */
+void ParallelForRows(int rows, std::size_t row_bytes,
+                     const std::function<void(int, int)> &body);
+
+}  // namespace util
+}  // namespace video_detect
+
+#endif  // VIDEO_DETECT_INCLUDE_VIDEO_DETECT_UTIL_THREAD_POOL_H_
@@ -0,0 +1,93 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#include "video-detect/divisor_votes.h"
+
+#include <algorithm>
+
+namespace video_detect {
+
+DivisorVotes::DivisorVotes(int max_divisor)
+    : max_divisor_(max_divisor),
+      votes_(max_divisor + 1, 0),
+      modulo_sums_(max_divisor + 1, 0) {}
+
+void DivisorVotes::SetSize(int size) {
+  if (size == size_) {
+    return;
+  }
+  size_ = size;
+
+  // A position votes for size / position tiles if the first decimal of the
+  // division is zero, which in integers is 10 * size / position being a
+  // multiple of 10. Position 0, the full size itself and the amounts above
+  // the maximum map to the unused 0. The amount only decreases with the
+  // position, so the positions below the first valid one are skipped.
+  divisors_.assign(size, 0);
+  const int kFirst = std::max(2, size / (max_divisor_ + 1));
+  for (int position = kFirst; position < size; position++) {
+    const int kTenths = (10 * size) / position;
+    const bool kValid = kTenths % 10 == 0 && kTenths / 10 <= max_divisor_;
+    divisors_[position] = kValid ? kTenths / 10 : 0;
+  }
+}
+
+void DivisorVotes::Merge(const DivisorVotes &other) {
+  if (size_ == 0 && other.size_ != 0) {
+    SetSize(other.size_);
+  }
+
+  // Both objects counted the first vote for an amount as 1 and every other
+  // vote as the amount, so the merged votes count one first vote less
+  const int kMaxDivisor = std::min(max_divisor_, other.max_divisor_);
+  for (int divisor = 1; divisor <= kMaxDivisor; divisor++) {
+    const int kOtherVotes = other.votes_[divisor];
+    if (kOtherVotes == 0) {
+      continue;
+    }
+    if (votes_[divisor] == 0) {
+      AddCandidate(divisor);
+      votes_[divisor] = kOtherVotes;
+    } else {
+      votes_[divisor] += kOtherVotes - 1 + divisor;
+    }
+  }
+}
+
+void DivisorVotes::AddCandidate(int divisor) {
+  for (int other = 1; other <= max_divisor_; other++) {
+    modulo_sums_[other] += other % divisor;
+  }
+}
+
+int DivisorVotes::GetBestDivisor() const {
+  int best = 0;
+  float best_score = 0.f;
+  for (int divisor = 1; divisor <= max_divisor_; divisor++) {
+    if (votes_[divisor] == 0) {
+      continue;
+    }
+
+    // Weight the modulo sum with the frequency
+    const float kScore =
+        (1.f * modulo_sums_[divisor]) / (1.f * votes_[divisor]);
+    if (best == 0 || kScore < best_score) {
+      best = divisor;
+      best_score = kScore;
+    }
+  }
+  return best;
+}
+
+std::vector<int> DivisorVotes::GetCandidates() const {
+  std::vector<int> candidates;
+  for (int divisor = 1; divisor <= max_divisor_; divisor++) {
+    if (votes_[divisor] != 0) {
+      candidates.push_back(divisor);
+    }
+  }
+  return candidates;
+}
+
+}  // namespace video_detect
@@ -6,7 +6,11 @@
  * Source: https://gist.github.com/yohhoy/f0444d3fc47f2bb2d0e2
  */
 
+#include <chrono>
 #include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
 #include <vector>
 
 // FFmpeg
@@ -18,155 +22,440 @@ extern "C" {
 #include <libavformat/avformat.h>
 #include <libavutil/avutil.h>
 #include <libavutil/pixdesc.h>
-#include <libswscale/swscale.h>
 
 #ifdef __cplusplus
 }
 #endif
 
-// OpenCV
-#include <opencv2/core.hpp>
-#include <opencv2/highgui.hpp>
-
 #include "video-detect/ffmpeg/ff2cv.h"
+#include "video-detect/ffmpeg/luma_converter.h"
 
 namespace video_detect {
 namespace ffmpeg {
 
-int ff2cv(const char *video_file, int modulo_frame_count,
-          video_detect::util::ObjectReceiver<const cv::Mat&> *receiver) {
-  // initialize FFmpeg library
+namespace {
+
+/**
+ * Counts the decoded frames to report the decoding throughput
+ */
+class ThroughputCounter {
+ public:
+  ThroughputCounter() : start_(std::chrono::steady_clock::now()) {}
+
+  void Add() { ++frames_; }
+
+  /**
+   * Print the decoded frames, the elapsed time and the frames per second in a
+   * single write, so lines of concurrent decoders do not interleave
+   */
+  void Print(const std::string &prefix) const {
+    const std::chrono::duration<double> kElapsed =
+        std::chrono::steady_clock::now() - start_;
+    std::ostringstream line;
+    line << prefix << frames_ << " frames decoded in " << kElapsed.count()
+         << " [sec], "
+         << (kElapsed.count() > 0. ? frames_ / kElapsed.count() : 0.)
+         << " [fps]\n";
+    std::cout << line.str() << std::flush;
+  }
+
+ private:
+  const std::chrono::steady_clock::time_point start_;
+  unsigned frames_ = 0;
+};
+
+/**
+ * Open the video file and a decoder for its primary video stream, and print
+ * the stream information if requested
+ *
+ * @return int 0 on success, 2 on failure
+ */
+int OpenVideo(const char *video_file, const DecoderSettings &decoder_settings,
+              bool print_info, AVFormatContext **inctx, AVStream **vstrm,
+              AVCodecContext **codec) {
+  // initialize FFmpeg library, which is done automatically since 4.0
+#if LIBAVFORMAT_VERSION_INT < AV_VERSION_INT(58, 9, 100)
   av_register_all();
+#endif
   //  av_log_set_level(AV_LOG_DEBUG);
   int ret;
 
   // open input file context
-  AVFormatContext *inctx = nullptr;
-  ret = avformat_open_input(&inctx, video_file, nullptr, nullptr);
+  ret = avformat_open_input(inctx, video_file, nullptr, nullptr);
   if (ret < 0) {
     std::cerr << "fail to avforamt_open_input(\"" << video_file
               << "\"): ret=" << ret;
     return 2;
   }
   // retrive input stream information
-  ret = avformat_find_stream_info(inctx, nullptr);
+  ret = avformat_find_stream_info(*inctx, nullptr);
   if (ret < 0) {
     std::cerr << "fail to avformat_find_stream_info: ret=" << ret;
     return 2;
   }
 
   // find primary video stream
-  AVCodec *vcodec = nullptr;
-  ret = av_find_best_stream(inctx, AVMEDIA_TYPE_VIDEO, -1, -1, &vcodec, 0);
+  ret = av_find_best_stream(*inctx, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
   if (ret < 0) {
     std::cerr << "fail to av_find_best_stream: ret=" << ret;
     return 2;
   }
-  const int vstrm_idx = ret;
-  AVStream *vstrm = inctx->streams[vstrm_idx];
+  *vstrm = (*inctx)->streams[ret];
+  const AVCodec *vcodec = avcodec_find_decoder((*vstrm)->codecpar->codec_id);
+  if (vcodec == nullptr) {
+    std::cerr << "fail to avcodec_find_decoder";
+    return 2;
+  }
+
+  // create video decoder context from the stream parameters
+  *codec = avcodec_alloc_context3(vcodec);
+  if (*codec == nullptr) {
+    std::cerr << "fail to avcodec_alloc_context3";
+    return 2;
+  }
+  ret = avcodec_parameters_to_context(*codec, (*vstrm)->codecpar);
+  if (ret < 0) {
+    std::cerr << "fail to avcodec_parameters_to_context: ret=" << ret;
+    return 2;
+  }
+  (*codec)->pkt_timebase = (*vstrm)->time_base;
+
+  // let the decoder discard the skipped frames before decoding them
+  if (decoder_settings.frame_skip == FrameSkip::kNonReference) {
+    (*codec)->skip_frame = AVDISCARD_NONREF;
+  } else if (decoder_settings.frame_skip == FrameSkip::kNonKey) {
+    (*codec)->skip_frame = AVDISCARD_NONKEY;
+  }
+
+  // spread the decoding over the threads
+  (*codec)->thread_count = decoder_settings.thread_count;
+  if (decoder_settings.threading == DecodeThreading::kFrame) {
+    (*codec)->thread_type = FF_THREAD_FRAME;
+  } else if (decoder_settings.threading == DecodeThreading::kSlice) {
+    (*codec)->thread_type = FF_THREAD_SLICE;
+  } else {
+    (*codec)->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+  }
 
   // open video decoder context
-  ret = avcodec_open2(vstrm->codec, vcodec, nullptr);
+  ret = avcodec_open2(*codec, vcodec, nullptr);
   if (ret < 0) {
     std::cerr << "fail to avcodec_open2: ret=" << ret;
     return 2;
   }
 
+  if (!print_info) {
+    return 0;
+  }
+
   // print input video stream informataion
   std::cout << "video_file: " << video_file << "\n"
-            << "format: " << inctx->iformat->name << "\n"
+            << "format: " << (*inctx)->iformat->name << "\n"
             << "vcodec: " << vcodec->name << "\n"
-            << "size:   " << vstrm->codec->width << 'x' << vstrm->codec->height
-            << "\n"
-            << "fps:    " << av_q2d(vstrm->codec->framerate) << " [fps]\n"
+            << "size:   " << (*codec)->width << 'x' << (*codec)->height << "\n"
+            << "fps:    " << av_q2d((*vstrm)->avg_frame_rate) << " [fps]\n"
             << "length: "
-            << av_rescale_q(vstrm->duration, vstrm->time_base, {1, 1000}) /
+            << av_rescale_q((*vstrm)->duration, (*vstrm)->time_base,
+                            {1, 1000}) /
                    1000.
             << " [sec]\n"
-            << "pixfmt: " << av_get_pix_fmt_name(vstrm->codec->pix_fmt) << "\n"
-            << "frame:  " << vstrm->nb_frames << "\n"
+            << "pixfmt: " << av_get_pix_fmt_name((*codec)->pix_fmt) << "\n"
+            << "frame:  " << (*vstrm)->nb_frames << "\n"
+            << "thread: " << (*codec)->thread_count << " x "
+            << ((*codec)->active_thread_type == FF_THREAD_FRAME
+                    ? "frame"
+                    : (*codec)->active_thread_type == FF_THREAD_SLICE
+                          ? "slice"
+                          : "none")
+            << "\n"
             << std::flush;
 
-  // initialize sample scaler
-  const int dst_width = vstrm->codec->width;
-  const int dst_height = vstrm->codec->height;
-  const AVPixelFormat dst_pix_fmt = AV_PIX_FMT_BGR24;
-  SwsContext *swsctx =
-      sws_getCachedContext(nullptr, vstrm->codec->width, vstrm->codec->height,
-                           vstrm->codec->pix_fmt, dst_width, dst_height,
-                           dst_pix_fmt, SWS_BICUBIC, nullptr, nullptr, nullptr);
-  if (!swsctx) {
-    std::cerr << "fail to sws_getCachedContext";
+  // the grayscale image is the luma plane for YUV formats, other formats are
+  // converted by sws_scale
+  std::cout << "output: " << (*codec)->width << 'x' << (*codec)->height << ','
+            << (LumaConverter::HasLumaPlane((*codec)->pix_fmt)
+                    ? "luma plane"
+                    : av_get_pix_fmt_name(AV_PIX_FMT_GRAY8))
+            << std::endl;
+  return 0;
+}
+
+void CloseVideo(AVFormatContext **inctx, AVCodecContext **codec) {
+  avcodec_free_context(codec);
+  avformat_close_input(inctx);
+}
+
+/**
+ * Send a packet to the decoder and pass each frame it completes on to the
+ * frame handler, until the handler returns false. A null packet drains the
+ * decoder at the end of the stream. Packets the decoder rejects as corrupt are
+ * skipped.
+ *
+ * @return bool false if the frame handler stopped the decoding
+ */
+template <typename FrameHandler>
+bool DecodePacket(AVCodecContext *codec, const AVPacket *pkt, AVFrame *frame,
+                  ThroughputCounter *throughput, FrameHandler handler) {
+  if (avcodec_send_packet(codec, pkt) < 0) {
+    return true;
+  }
+  while (avcodec_receive_frame(codec, frame) == 0) {
+    throughput->Add();
+    const bool kContinue = handler(frame);
+    av_frame_unref(frame);
+    if (!kContinue) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Get the timestamp of the first frame, in the time base of the video stream
+ */
+int64_t GetStreamStart(const AVStream *vstrm) {
+  return vstrm->start_time != AV_NOPTS_VALUE ? vstrm->start_time : 0;
+}
+
+/**
+ * Get the length of the video stream in its time base
+ *
+ * @param vstrm the video stream
+ * @param duration the duration of the input in AV_TIME_BASE units, used when
+ * the stream does not know its own duration
+ * @return int64_t the length, 0 if it is unknown
+ */
+int64_t GetStreamLength(const AVStream *vstrm, int64_t duration) {
+  if (vstrm->duration != AV_NOPTS_VALUE && vstrm->duration > 0) {
+    return vstrm->duration;
+  }
+  return duration != AV_NOPTS_VALUE
+             ? av_rescale_q(duration, AV_TIME_BASE_Q, vstrm->time_base)
+             : 0;
+}
+
+}  // namespace
+
+std::vector<int64_t> GetSampleTimestamps(int64_t start, int64_t length,
+                                         double time_base,
+                                         double sample_interval,
+                                         int sample_count) {
+  // Sample in the middle of each of the equally long parts of the video
+  std::vector<int64_t> timestamps;
+  for (int i = 0; i < sample_count && length > 0; i++) {
+    timestamps.push_back(start + length * (2 * i + 1) / (2 * sample_count));
+  }
+
+  // Sample every interval, starting at the first frame
+  const double kStep = sample_interval / time_base;
+  for (int i = 0; sample_interval > 0. && kStep * i < length; i++) {
+    timestamps.push_back(start + static_cast<int64_t>(kStep * i));
+  }
+  return timestamps;
+}
+
+int ff2cv(const char *video_file, int modulo_frame_count,
+          const DecoderSettings &decoder_settings,
+          video_detect::util::ObjectReceiver<mat::Mat2D<uint8_t>> *receiver) {
+  return ff2cv_segment(video_file, modulo_frame_count, 0, 1, decoder_settings,
+                       receiver);
+}
+
+int ff2cv_segment(
+    const char *video_file, int modulo_frame_count, int segment,
+    int segment_count, const DecoderSettings &decoder_settings,
+    video_detect::util::ObjectReceiver<mat::Mat2D<uint8_t>> *receiver) {
+  AVFormatContext *inctx = nullptr;
+  AVStream *vstrm = nullptr;
+  AVCodecContext *codec = nullptr;
+  int ret = OpenVideo(video_file, decoder_settings, segment == 0, &inctx,
+                      &vstrm, &codec);
+  if (ret != 0) {
+    CloseVideo(&inctx, &codec);
+    return ret;
+  }
+
+  // the segment holds the frames with a timestamp in [begin, end) of an equal
+  // part of the video, the first and the last segment are open ended
+  const int64_t kStart = GetStreamStart(vstrm);
+  const int64_t kLength = GetStreamLength(vstrm, inctx->duration);
+  if (segment_count > 1 && kLength <= 0) {
+    std::cerr << "fail to segment: unknown video length";
+    CloseVideo(&inctx, &codec);
     return 2;
   }
-  std::cout << "output: " << dst_width << 'x' << dst_height << ','
-            << av_get_pix_fmt_name(dst_pix_fmt) << std::endl;
+  const int64_t kBegin = segment > 0
+                             ? kStart + kLength * segment / segment_count
+                             : std::numeric_limits<int64_t>::min();
+  const int64_t kEnd = segment + 1 < segment_count
+                           ? kStart + kLength * (segment + 1) / segment_count
+                           : std::numeric_limits<int64_t>::max();
 
-  // allocate frame buffer for output
-  AVFrame *frame = av_frame_alloc();
-  std::vector<uint8_t> framebuf(
-      avpicture_get_size(dst_pix_fmt, dst_width, dst_height));
-  avpicture_fill(reinterpret_cast<AVPicture *>(frame), framebuf.data(),
-                 dst_pix_fmt, dst_width, dst_height);
+  // start decoding at the keyframe preceding the segment
+  if (segment > 0) {
+    ret = av_seek_frame(inctx, vstrm->index, kBegin, AVSEEK_FLAG_BACKWARD);
+    if (ret < 0) {
+      std::cerr << "fail to av_seek_frame: ret=" << ret;
+      CloseVideo(&inctx, &codec);
+      return 2;
+    }
+  }
 
   // decoding loop
+  LumaConverter converter;
+  ThroughputCounter throughput;
   AVFrame *decframe = av_frame_alloc();
+  AVPacket *pkt = av_packet_alloc();
   unsigned nb_frames = 0;
+  bool in_segment = segment == 0;
+  auto handle_frame = [&](const AVFrame *frame) {
+    // frames before the segment belong to the previous one, the first frame
+    // after it ends the segment. Frames without a timestamp belong to the
+    // segment of the frames before them, so a later segment drops them until
+    // its first frame, else each segment would vote for them.
+    const int64_t kTimestamp = frame->best_effort_timestamp;
+    if (kTimestamp == AV_NOPTS_VALUE) {
+      if (!in_segment) {
+        return true;
+      }
+    } else if (kTimestamp < kBegin) {
+      return true;
+    } else if (kTimestamp >= kEnd) {
+      return false;
+    } else {
+      in_segment = true;
+    }
+
+    //////////////////////////////////////////////////////////////////
+    // START - Custom code
+
+    // Grab only modulo_frame_count'th frame (customizable later), the other
+    // frames are released without any further work
+    if (nb_frames % modulo_frame_count == 0) {
+      // Convert the frame to a grayscale matrix and send it to the receiver
+      receiver->Accept(converter.Convert(frame));
+      if (segment_count == 1) {
+        std::cout << nb_frames << '\r' << std::flush;  // dump progress
+      }
+    }
+    // END - Custom Code
+    //////////////////////////////////////////////////////////////////
+
+    ++nb_frames;
+    return true;
+  };
   bool end_of_stream = false;
-  int got_pic = 0;
-  AVPacket pkt;
-  do {
-    if (!end_of_stream) {
-      // read packet from input file
-      ret = av_read_frame(inctx, &pkt);
+  bool end_of_segment = false;
+  while (!end_of_stream && !end_of_segment) {
+    // read packet from input file
+    ret = av_read_frame(inctx, pkt);
+    if (ret < 0 && ret != AVERROR_EOF) {
+      std::cerr << "fail to av_read_frame: ret=" << ret;
+      break;
+    }
+    end_of_stream = (ret == AVERROR_EOF);
+    if (!end_of_stream && pkt->stream_index != vstrm->index) {
+      av_packet_unref(pkt);
+      continue;
+    }
+
+    // decode video frames, the null packet at the end drains the decoder
+    end_of_segment = !DecodePacket(codec, end_of_stream ? nullptr : pkt,
+                                   decframe, &throughput, handle_frame);
+    av_packet_unref(pkt);
+  }
+  const std::string kPrefix =
+      segment_count > 1 ? "segment " + std::to_string(segment) + ": " : "";
+  throughput.Print(kPrefix);
+
+  av_packet_free(&pkt);
+  av_frame_free(&decframe);
+  CloseVideo(&inctx, &codec);
+  return ret < 0 && ret != AVERROR_EOF ? 2 : 0;
+}
+
+int ff2cv_sampled(
+    const char *video_file, double sample_interval, int sample_count,
+    const DecoderSettings &decoder_settings,
+    video_detect::util::ObjectReceiver<mat::Mat2D<uint8_t>> *receiver) {
+  AVFormatContext *inctx = nullptr;
+  AVStream *vstrm = nullptr;
+  AVCodecContext *codec = nullptr;
+  int ret = OpenVideo(video_file, decoder_settings, true, &inctx, &vstrm,
+                      &codec);
+  if (ret != 0) {
+    CloseVideo(&inctx, &codec);
+    return ret;
+  }
+  const std::vector<int64_t> kTimestamps = GetSampleTimestamps(
+      GetStreamStart(vstrm), GetStreamLength(vstrm, inctx->duration),
+      av_q2d(vstrm->time_base), sample_interval, sample_count);
+  if (kTimestamps.empty()) {
+    std::cerr << "fail to sample: unknown video length";
+    CloseVideo(&inctx, &codec);
+    return 2;
+  }
+
+  // sampling loop, seek to the keyframe preceding each timestamp and decode
+  // forward up to the first frame at or after the timestamp
+  LumaConverter converter;
+  ThroughputCounter throughput;
+  AVFrame *decframe = av_frame_alloc();
+  AVPacket *pkt = av_packet_alloc();
+  unsigned nb_samples = 0;
+  bool end_of_stream = false;
+  bool failed = false;
+  for (int64_t timestamp : kTimestamps) {
+    ret = av_seek_frame(inctx, vstrm->index, timestamp, AVSEEK_FLAG_BACKWARD);
+    if (ret < 0) {
+      std::cerr << "fail to av_seek_frame: ret=" << ret << std::endl;
+      failed = true;
+      break;
+    }
+    // drop the frames of the previous position held by the decoder
+    avcodec_flush_buffers(codec);
+
+    bool sampled = false;
+    while (!sampled && !end_of_stream) {
+      ret = av_read_frame(inctx, pkt);
       if (ret < 0 && ret != AVERROR_EOF) {
-        std::cerr << "fail to av_read_frame: ret=" << ret;
-        return 2;
+        std::cerr << "fail to av_read_frame: ret=" << ret << std::endl;
+        failed = true;
+        break;
       }
-      if (ret == 0 && pkt.stream_index != vstrm_idx) goto next_packet;
       end_of_stream = (ret == AVERROR_EOF);
-    }
-    if (end_of_stream) {
-      // null packet for bumping process
-      av_init_packet(&pkt);
-      pkt.data = nullptr;
-      pkt.size = 0;
-    }
-    // decode video frame
-    avcodec_decode_video2(vstrm->codec, decframe, &got_pic, &pkt);
-    if (!got_pic) goto next_packet;
-    // convert frame to OpenCV matrix
-    sws_scale(swsctx, decframe->data, decframe->linesize, 0, decframe->height,
-              frame->data, frame->linesize);
-    {
-      cv::Mat image(dst_height, dst_width, CV_8UC3, framebuf.data(),
-                    frame->linesize[0]);
-
-      //////////////////////////////////////////////////////////////////
-      // START - Custom code
-
-      // Grab only modulo_frame_count'th frame (customizable later)
-      if (nb_frames % modulo_frame_count == 0) {
-        // Send the image to the receiver
-        receiver->Accept(image);
+      if (!end_of_stream && pkt->stream_index != vstrm->index) {
+        av_packet_unref(pkt);
+        continue;
       }
-      // END - Custom Code
-      //////////////////////////////////////////////////////////////////
 
-      if (cv::waitKey(1) == 0x1b) break;
+      // at the end of the stream the frames the decoder holds are drained
+      sampled = !DecodePacket(
+          codec, end_of_stream ? nullptr : pkt, decframe, &throughput,
+          [&](const AVFrame *frame) {
+            // frames without a timestamp are taken as they are
+            const int64_t kFrameTimestamp = frame->best_effort_timestamp;
+            if (kFrameTimestamp != AV_NOPTS_VALUE &&
+                kFrameTimestamp < timestamp) {
+              return true;
+            }
+            receiver->Accept(converter.Convert(frame));
+            std::cout << nb_samples << '\r' << std::flush;  // dump progress
+            ++nb_samples;
+            return false;
+          });
+      av_packet_unref(pkt);
     }
-    std::cout << nb_frames << '\r' << std::flush;  // dump progress
-    ++nb_frames;
-  next_packet:
-    av_free_packet(&pkt);
-  } while (!end_of_stream || got_pic);
-  std::cout << nb_frames << " frames decoded" << std::endl;
+    // the timestamps increase, so none of the remaining ones can be reached
+    if (end_of_stream || failed) break;
+  }
+  std::cout << nb_samples << " frames sampled" << std::endl;
+  throughput.Print("");
 
+  av_packet_free(&pkt);
   av_frame_free(&decframe);
-  av_frame_free(&frame);
-  avcodec_close(vstrm->codec);
-  avformat_close_input(&inctx);
-  return 0;
+  CloseVideo(&inctx, &codec);
+  return failed ? 2 : 0;
 }
 
 }  // namespace ffmpeg
@@ -0,0 +1,71 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#include "video-detect/ffmpeg/frame_plane_adapter.h"
+
+// FFmpeg
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <libavutil/frame.h>
+#include <libavutil/pixdesc.h>
+
+#ifdef __cplusplus
+}
+#endif
+
+namespace video_detect {
+namespace ffmpeg {
+
+namespace {
+
+mat::Mat2DView<const uint8_t> MakePlaneView(const AVFrame *frame, int plane) {
+  if (frame == nullptr || plane < 0 || plane >= AV_NUM_DATA_POINTERS ||
+      frame->data[plane] == nullptr) {
+    return mat::Mat2DView<const uint8_t>();
+  }
+
+  const AVPixFmtDescriptor *desc =
+      av_pix_fmt_desc_get(static_cast<AVPixelFormat>(frame->format));
+  if (desc == nullptr || (desc->flags & AV_PIX_FMT_FLAG_BITSTREAM)) {
+    return mat::Mat2DView<const uint8_t>();
+  }
+
+  // Find the component stored in this plane, it must be a single 8-bit value
+  // per pixel for the plane to be viewable
+  int component = -1;
+  for (int i = 0; i < desc->nb_components; i++) {
+    if (desc->comp[i].plane == plane) {
+      if (component >= 0 || desc->comp[i].depth != 8 ||
+          desc->comp[i].step != 1) {
+        return mat::Mat2DView<const uint8_t>();
+      }
+      component = i;
+    }
+  }
+  if (component < 0) {
+    return mat::Mat2DView<const uint8_t>();
+  }
+
+  // Chroma planes (components 1 & 2 of YUV formats) are subsampled
+  int rows = frame->height;
+  int cols = frame->width;
+  if ((component == 1 || component == 2) &&
+      !(desc->flags & AV_PIX_FMT_FLAG_RGB)) {
+    rows = AV_CEIL_RSHIFT(rows, desc->log2_chroma_h);
+    cols = AV_CEIL_RSHIFT(cols, desc->log2_chroma_w);
+  }
+
+  return mat::Mat2DView<const uint8_t>(frame->data[plane], rows, cols,
+                                       frame->linesize[plane]);
+}
+
+}  // namespace
+
+FramePlaneAdapter::FramePlaneAdapter(const AVFrame *frame, int plane)
+    : mat::Mat2DView<const uint8_t>(MakePlaneView(frame, plane)) {}
+
+}  // namespace ffmpeg
+}  // namespace video_detect
@@ -0,0 +1,169 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#include "video-detect/ffmpeg/luma_converter.h"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+// FFmpeg
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <libavutil/frame.h>
+#include <libavutil/pixdesc.h>
+#include <libavutil/pixfmt.h>
+#include <libswscale/swscale.h>
+
+#ifdef __cplusplus
+}
+#endif
+
+#include "video-detect/ffmpeg/frame_plane_adapter.h"
+#include "video-detect/mat/lut_u8.h"
+
+namespace video_detect {
+namespace ffmpeg {
+
+namespace {
+
+void FreeFrame(void *frame) {
+  AVFrame *av_frame = static_cast<AVFrame *>(frame);
+  av_frame_free(&av_frame);
+}
+
+// Expand limited range luma of [16, 235] to the full range of [0, 255]
+mat::LutU8 BuildLimitedToFullRangeLut() {
+  mat::LutU8 lut;
+  for (int value = 0; value < static_cast<int>(lut.size()); value++) {
+    const int kLuma = std::min(std::max(value, 16), 235) - 16;
+    lut[value] = static_cast<uint8_t>((kLuma * 255 + 219 / 2) / 219);
+  }
+  return lut;
+}
+
+const mat::LutU8 kLimitedToFullRange = BuildLimitedToFullRangeLut();
+
+}  // namespace
+
+LumaConverter::~LumaConverter() { sws_freeContext(sws_context_); }
+
+bool LumaConverter::HasLumaPlane(int format) {
+  const AVPixFmtDescriptor *desc =
+      av_pix_fmt_desc_get(static_cast<AVPixelFormat>(format));
+  if (desc == nullptr || desc->nb_components < 1 ||
+      (desc->flags & (AV_PIX_FMT_FLAG_RGB | AV_PIX_FMT_FLAG_PAL |
+                      AV_PIX_FMT_FLAG_BITSTREAM | AV_PIX_FMT_FLAG_HWACCEL))) {
+    return false;
+  }
+
+  // Component 0 of YUV and gray formats is the luma, it must be the only
+  // component of plane 0 and hold one 8-bit value per pixel
+  if (desc->comp[0].plane != 0 || desc->comp[0].depth != 8 ||
+      desc->comp[0].step != 1) {
+    return false;
+  }
+  for (int i = 1; i < desc->nb_components; i++) {
+    if (desc->comp[i].plane == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool LumaConverter::IsFullRange(const AVFrame *frame) {
+  if (frame->color_range != AVCOL_RANGE_UNSPECIFIED) {
+    return frame->color_range == AVCOL_RANGE_JPEG;
+  }
+
+  // Without a range the gray and the YUVJ formats are full range and the
+  // other YUV formats limited range, as swscale assumes
+  switch (frame->format) {
+    case AV_PIX_FMT_GRAY8:
+    case AV_PIX_FMT_YUVJ420P:
+    case AV_PIX_FMT_YUVJ422P:
+    case AV_PIX_FMT_YUVJ444P:
+    case AV_PIX_FMT_YUVJ440P:
+    case AV_PIX_FMT_YUVJ411P:
+      return true;
+    default:
+      return false;
+  }
+}
+
+mat::Mat2D<uint8_t> LumaConverter::Convert(const AVFrame *frame) {
+  if (frame == nullptr || frame->width <= 0 || frame->height <= 0) {
+    return mat::Mat2D<uint8_t>(0, 0);
+  }
+
+  const bool kFullRange = IsFullRange(frame);
+  if (HasLumaPlane(frame->format) && kFullRange) {
+    // Wrap the luma plane of a new reference to the frame buffer, only frames
+    // which are not reference counted are copied by av_frame_clone
+    AVFrame *reference = av_frame_clone(frame);
+    if (reference != nullptr) {
+      std::shared_ptr<void> owner(reference, &FreeFrame);
+      const FramePlaneAdapter kLuma(reference, 0);
+      return mat::Mat2D<uint8_t>(const_cast<uint8_t *>(kLuma.GetData()),
+                                 kLuma.GetRowCount(), kLuma.GetColCount(),
+                                 kLuma.GetStride(), std::move(owner));
+    }
+  } else if (HasLumaPlane(frame->format)) {
+    // Expand limited range luma into an owned matrix in the same pass that
+    // reads it, the frame buffer belongs to the decoder and is not written
+    const FramePlaneAdapter kLuma(frame, 0);
+    mat::Mat2D<uint8_t> result(kLuma.GetRowCount(), kLuma.GetColCount());
+    mat::ApplyLutU8(kLuma, kLimitedToFullRange, result.View());
+    return result;
+  }
+
+  // Convert any other format to full range gray at the same size
+  sws_context_ = sws_getCachedContext(
+      sws_context_, frame->width, frame->height,
+      static_cast<AVPixelFormat>(frame->format), frame->width, frame->height,
+      AV_PIX_FMT_GRAY8, SWS_POINT, nullptr, nullptr, nullptr);
+  if (sws_context_ == nullptr) {
+    return mat::Mat2D<uint8_t>(0, 0);
+  }
+  SetRange(frame);
+
+  mat::Mat2D<uint8_t> result(frame->height, frame->width);
+  uint8_t *dst_data[4] = {result.GetRowPtr(0), nullptr, nullptr, nullptr};
+  int dst_linesize[4] = {result.GetStride(), 0, 0, 0};
+  sws_scale(sws_context_, frame->data, frame->linesize, 0, frame->height,
+            dst_data, dst_linesize);
+  return result;
+}
+
+void LumaConverter::SetRange(const AVFrame *frame) {
+  // RGB is always full range, the range of the other formats is only taken
+  // from the format by swscale
+  const AVPixFmtDescriptor *desc =
+      av_pix_fmt_desc_get(static_cast<AVPixelFormat>(frame->format));
+  if (desc == nullptr || (desc->flags & AV_PIX_FMT_FLAG_RGB)) {
+    return;
+  }
+  const int kSrcRange = IsFullRange(frame) ? 1 : 0;
+
+  int *inv_table = nullptr;
+  int *table = nullptr;
+  int src_range = 0;
+  int dst_range = 0;
+  int brightness = 0;
+  int contrast = 0;
+  int saturation = 0;
+  if (sws_getColorspaceDetails(sws_context_, &inv_table, &src_range, &table,
+                               &dst_range, &brightness, &contrast,
+                               &saturation) < 0 ||
+      (src_range == kSrcRange && dst_range == 1)) {
+    return;
+  }
+  sws_setColorspaceDetails(sws_context_, inv_table, kSrcRange, table, 1,
+                           brightness, contrast, saturation);
+}
+
+}  // namespace ffmpeg
+}  // namespace video_detect
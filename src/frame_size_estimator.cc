@@ -4,42 +4,47 @@
 
 #include "video-detect/frame_size_estimator.h"
 
+#include <cstring>
 #include <iostream>
-#include <set>
 #include <utility>
 
-#include "video-detect/mat/filter.h"
+#include "video-detect/mat/contour.h"
+#include "video-detect/mat/gradient.h"
 #include "video-detect/mat/kernel_defs.h"
-#include "video-detect/mat/threshold.h"
 #include "video-detect/opencv2/export_u8_mat_2d.h"
-#include "video-detect/opencv2/mat_2d_adapter.h"
-#include "video-detect/opencv2/util.h"
 
 namespace video_detect {
 
 FrameSizeEstimator::FrameSizeEstimator(bool export_images,
                                        const std::string& export_path,
-                                       int confidence_level)
+                                       int confidence_level,
+                                       int max_grid_size)
     : export_images_(export_images),
       export_path_(export_path),
       confidence_level_(confidence_level),
-      best_estimate_found_(false) {}
+      rows_(max_grid_size),
+      cols_(max_grid_size),
+      best_estimate_found_(false),
+      gaussian_kernel_(mat::kKernelGaussian3x3),
+      threshold_(100, 200, 0, 255),
+      edge_pipeline_(gaussian_kernel_, threshold_, mat::GradientNorm::kL2),
+      line_feature_finder_(20, 15) {}
 
 void FrameSizeEstimator::Accept(const mat::Mat2D<uint8_t>& mat) {
   //
   // This is the main image analysis strategy
   //
+  // Every intermediate image is taken from the scratch pool and returned to it
+  // as soon as the next stage has replaced it, so that frames of the same size
+  // do not allocate any image buffers after the first one
+  //
 
   // 1. Apply a gaussian filter to smooth the image
-  MatU8 result = ApplyGaussianFilter(mat);
-
   // 2. Apply a threshold filter to remove out of bounds values
   //    This reduces noise later on
-  result = ApplyThresholdFilter(result);
-
   // 3. Apply a Sobel edge detection filter
   //    the resultant matrix is the sobel magnitude matrix
-  result = ApplyEdgeDetectionFilter(result);
+  MatU8 result = ApplyEdgeFilters(mat);
 
   // 4. Apply a Contour finder using the edge detected matrix
   result = ApplyContourFinder(result);
@@ -58,7 +63,7 @@ void FrameSizeEstimator::Accept(const mat::Mat2D<uint8_t>& mat) {
   UpdateBestEstimateFrameSizes(result.GetRowCount(), result.GetColCount(), 5);
 }
 
-void FrameSizeEstimator::ExportImage(ConstMatU8& mat,
+void FrameSizeEstimator::ExportImage(ConstViewU8 mat,
                                      const std::string& name_base) {
   // If the export images flag is set, export the image
   if (export_images_) {
@@ -66,20 +71,34 @@ void FrameSizeEstimator::ExportImage(ConstMatU8& mat,
     opencv2::ExportU8Mat2D exporter(name_base, export_path_);
 
     // Export the image
-    exporter.Accept(mat);
+    exporter.Export(mat);
   }
 }
 
-FrameSizeEstimator::MatU8 FrameSizeEstimator::ApplyGaussianFilter(
-    ConstMatU8& mat) {
-  // Create filter
-  mat::Filter<uint8_t, float> filter(mat::kKernelGaussian3x3);
+FrameSizeEstimator::MatU8 FrameSizeEstimator::ApplyEdgeFilters(
+    ConstViewU8 mat) {
+  // The intermediate images only exist when they are exported
+  if (export_images_) {
+    MatU8 result = ApplyGaussianFilter(mat);
+    ApplyThresholdFilter(result);
+    return ApplyEdgeDetectionFilter(result);
+  }
 
+  // Stream the rows through all three filters at once, such that the image is
+  // read and the magnitude is written only once
+  MatU8 result = scratch_.Acquire(mat.GetRowCount(), mat.GetColCount());
+  edge_pipeline_.Apply(mat, result);
+  return result;
+}
+
+FrameSizeEstimator::MatU8 FrameSizeEstimator::ApplyGaussianFilter(
+    ConstViewU8 mat) {
   // Export input image
   ExportImage(mat, "GaussianFilterInput");
 
-  // Filter image
-  MatU8 result = filter.Apply(mat);
+  // Filter image with the vectorized fixed point convolution
+  MatU8 result = scratch_.Acquire(mat.GetRowCount(), mat.GetColCount());
+  mat::ConvU8(mat, gaussian_kernel_, result);
 
   // Export output image
   ExportImage(result, "GaussianFilterOutput");
@@ -88,57 +107,40 @@ FrameSizeEstimator::MatU8 FrameSizeEstimator::ApplyGaussianFilter(
   return result;
 }
 
-FrameSizeEstimator::MatU8 FrameSizeEstimator::ApplyThresholdFilter(
-    ConstMatU8& mat) {
-  // Create filter
-  mat::Threshold<uint8_t> threshold(100, 200, 0, 255);
-
+void FrameSizeEstimator::ApplyThresholdFilter(ViewU8 mat) {
   // Export input image
   ExportImage(mat, "ThresholdFilterInput");
 
-  // Filter image
-  MatU8 result = threshold.Apply(mat);
+  // Filter image in a single pass through the lookup table of the threshold
+  threshold_.Apply(mat);
 
   // Export output image
-  ExportImage(result, "ThresholdFilterOutput");
-
-  // Return result
-  return result;
+  ExportImage(mat, "ThresholdFilterOutput");
 }
 
 FrameSizeEstimator::MatU8 FrameSizeEstimator::ApplyEdgeDetectionFilter(
-    ConstMatU8& mat) {
-  // Create filters
-  mat::Filter<uint8_t, int8_t> x_filter(mat::kSobelX3x3);
-  mat::Filter<uint8_t, int8_t> y_filter(mat::kSobelY3x3);
-
+    ConstViewU8 mat) {
   // Export input image
   ExportImage(mat, "EdgeDetectionFilterInput");
 
-  // Filter images
-  auto x_mat = x_filter.Apply(mat).CastTo<float>();
-  auto y_mat = y_filter.Apply(mat).CastTo<float>();
+  // Calculate the Sobel Magnitude => mag = sqrt(x² + y²) in a single pass,
+  // the gradients are calculated in int16 and the magnitude saturates
+  MatU8 result_mag = scratch_.Acquire(mat.GetRowCount(), mat.GetColCount());
+  mat::SobelGradient(mat, result_mag, mat::GradientNorm::kL2);
 
-  // Calculate Sobel Magnitude => mag = sqrt(x_mat² + y_mat²);
-  auto result_mag =
-      ((x_mat * x_mat) + (y_mat * y_mat)).Sqrt().CastTo<uint8_t>();
-
-  // Export output images - checking with int to prevent casting
-  if (export_images_) {
-    ExportImage(x_mat.CastTo<uint8_t>(), "EdgeDetectionFilterOutput_X");
-    ExportImage(y_mat.CastTo<uint8_t>(), "EdgeDetectionFilterOutput_Y");
-    ExportImage(result_mag, "EdgeDetectionFilterOutputMag");
-  }
+  // Export output image
+  ExportImage(result_mag, "EdgeDetectionFilterOutputMag");
 
-  // Calculate the magnitude image
-  return result_mag.CastTo<uint8_t>();
+  // Return the magnitude image
+  return result_mag;
 }
 
 FrameSizeEstimator::MatU8 FrameSizeEstimator::ApplyContourFinder(
-    ConstMatU8& mat) {
-  // Use open cv to calculate the contours
-  auto result = opencv2::Mat2DAdapter<uint8_t>(
-      opencv2::FindContoursMatrix(opencv2::ConvertMat2DToCvMat(mat)));
+    ConstViewU8 mat) {
+  // Mark the boundary pixels of the edges directly, the contours themselves
+  // are not needed by the next stages
+  MatU8 result = scratch_.Acquire(mat.GetRowCount(), mat.GetColCount());
+  mat::ContourMask(mat, result);
 
   // Export images
   ExportImage(result, "ContourFinderOutput");
@@ -148,110 +150,36 @@ FrameSizeEstimator::MatU8 FrameSizeEstimator::ApplyContourFinder(
 }
 
 FrameSizeEstimator::MatU8 FrameSizeEstimator::ApplyLinearFeatureFinder(
-    ConstMatU8& mat) {
-  // Local variables
-  static const int kLineLengthH = 20;
-  static const int kLineLengthV = 15;
-  int line_counter = 0;
-  MatU8 result_h(mat.GetRowCount(), mat.GetColCount());
-  MatU8 result_v(mat.GetRowCount(), mat.GetColCount());
-
-  // Find linear features -> HORIZONTAL
-  for (int row = 0; row < mat.GetRowCount(); row++) {
-    for (int col = 0; col < mat.GetColCount(); col++) {
-      // Go through each column to check if we have a linear line
-      if (mat.GetValue(row, col) == 255) {
-        ++line_counter;
-      } else if (line_counter >= kLineLengthH) {
-        // This means we have a horizontal line -> color it in!
-        for (int x = col - line_counter; x <= col; x++) {
-          result_h.SetValue(row, x, 255);
-        }
-        line_counter = 0;
-      } else {
-        // This means we did not detect a horizontal line
-        line_counter = 0;
-      }
-    }
-    line_counter = 0;
-  }
-
-  // Find linear features -> VERTICAL
-  for (int col = 0; col < mat.GetColCount(); col++) {
-    for (int row = 0; row < mat.GetRowCount(); row++) {
-      // Go through each column to check if we have a linear line
-      if (mat.GetValue(row, col) == 255) {
-        ++line_counter;
-      } else if (line_counter >= kLineLengthV) {
-        // This means we have a vertical line -> color it in!
-        for (int y = row - line_counter; y <= row; y++) {
-          result_v.SetValue(y, col, 255);
-        }
-        line_counter = 0;
-      } else {
-        // This means we did not detect a vertical line
-        line_counter = 0;
-      }
-    }
-    line_counter = 0;
-  }
-
-  auto result = result_v + result_h;
+    ConstViewU8 mat) {
+  // Find the horizontal and vertical lines in a single row by row pass, the
+  // mask holds both and the segments are kept in the finder
+  MatU8 result = scratch_.Acquire(mat.GetRowCount(), mat.GetColCount());
+  line_feature_finder_.Apply(mat, result);
   ExportImage(result, "LinearFeatureFinderOutput");
   return result;
 }
 
-std::map<int, int> FrameSizeEstimator::ApplyCornerFinder(ConstMatU8& mat) {
+const std::vector<FrameSizeEstimator::Corner>&
+FrameSizeEstimator::ApplyCornerFinder(ConstViewU8 mat) {
   // Local variables
-  MatU8 result(mat.GetRowCount(), mat.GetColCount());
-  std::map<int, int> corners;
+  MatU8 result = scratch_.Acquire(mat.GetRowCount(), mat.GetColCount());
   static const int kLineLength = 10;
 
-  // Find corners features
-  for (int col = 0; col < mat.GetColCount(); col++) {
-    for (int row = 0; row < mat.GetRowCount(); row++) {
-      // Go through each column to check if we have a corner line
-      // First ensure that we are on a Horizontal line
-
-      // Check if we are on a horizontal line
-      int line_counter = 0;
-      int x = col - kLineLength;
-
-      // Continue the loop for the set line length, stop if the line
-      // counter has reached that length
-      while ((x <= col + kLineLength) && (line_counter < kLineLength)) {
-        if (mat.GetValue(row, x) == 255) {
-          line_counter++;
-        }
-
-        x++;
-      }
-
-      // This means we are on a horizontal line
-      if (line_counter >= kLineLength) {
-        // Check if we are on a vertical line crossing
-        line_counter = 0;
-
-        // Continue the loop for the set line length, stop if the line
-        // counter has reached that length
-        int y = row - kLineLength;
-        while ((y <= row + kLineLength) && (line_counter < kLineLength)) {
-          if (mat.GetValue(y, col) == 255) {
-            line_counter++;
-          }
-
-          y++;
-        }
-
-        // This means we are on a vertical line which also means we are on a
-        // corner where a H-Line and V-Line meets which increases the
-        // probability that this is in fact a frame corener
-        if (line_counter >= kLineLength) {
-          result.SetValue(row, col, 255);
-          // Add to corners
-          corners.insert(std::make_pair(row, col));
-        }
-      }
+  // Find the corners where a H-Line and V-Line meet, which increases the
+  // probability that this is in fact a frame corner. A pixel is on a line if
+  // at least kLineLength of the pixels within kLineLength of it are.
+  mat::FindLineCrossings(mat, kLineLength, kLineLength, result);
+
+  // List every corner, the vector keeps its capacity across frames
+  corners_.clear();
+  for (int row = 0; row < result.GetRowCount(); row++) {
+    const uint8_t* src = result.View().GetRowPtr(row);
+    const uint8_t* const kEnd = src + result.GetColCount();
+    const uint8_t* corner = src;
+    while ((corner = static_cast<const uint8_t*>(
+                std::memchr(corner, 255, kEnd - corner))) != nullptr) {
+      corners_.push_back({row, static_cast<int>(corner - src)});
+      corner++;
     }
   }
 
@@ -259,68 +187,20 @@ std::map<int, int> FrameSizeEstimator::ApplyCornerFinder(ConstMatU8& mat) {
   ExportImage(result, "CornerFinderOutput");
 
   // Return corners
-  return corners;
+  return corners_;
 }
 
-void FrameSizeEstimator::UpdateFrameSizes(std::map<int, int> corners, int rows,
-                                          int cols) {
+void FrameSizeEstimator::UpdateFrameSizes(const std::vector<Corner>& corners,
+                                          int rows, int cols) {
   // We know that the frames should fit into the width x height of the image
-  // We can thus check to see if the founded corners fits into that window
-  for (const auto& corner : corners) {
-    float result_row = (rows * 1.f);
-
-    // Ensure that the corner's row is not zero to prevent zero-division
-    if (corner.first > 0) {
-      // Divide the total rows i.e. window height by the corner's row-position
-      result_row /= (corner.first * 1.f);
-
-      // Truncate the value to 1 decimal
-      result_row = truncf(result_row * 10) / 10;
-
-      // Check if the value has a zero-digit as a first decimal
-      if (static_cast<int>(result_row * 10) % 10 == 0) {
-        // This means we have divided the height of the matrix perfectly by the
-        // row-position of the corner.
-        auto it = rows_.find(static_cast<int>(result_row));
-        if (it != rows_.end()) {
-          // Add the candidate amount of rows in the height of the window to its
-          // cummulative sum
-          it->second += static_cast<int>(result_row);
-        } else if (static_cast<int>(result_row) != rows) {
-          // Insert the first occurance of this exact row count into the
-          // row count holder
-          rows_[static_cast<int>(result_row)] = 1;
-        }
-      }
-    }
-
-    // Now perform the same for the columns
-    float result_col = (cols * 1.f);
-
-    // Ensure that the corner's column is not zero to prevent zero-division
-    if (corner.second > 0) {
-      // Divide the total columns i.e. window width by the corner's col-position
-      result_col /= (corner.second * 1.f);
-
-      // Truncate the value to 1 decimal
-      result_col = truncf(result_col * 10) / 10;
-
-      // Check if the value has a zero-digit as a first decimal
-      if (static_cast<int>(result_col * 10) % 10 == 0) {
-        // This means we have divided the width of the matrix perfectly by the
-        // col-position of the corner.
-        auto it = cols_.find(static_cast<int>(result_col));
-        if (it != cols_.end()) {
-          // Add the candidate amount of cols in the width of the window to its
-          // cummulative sum
-          it->second += static_cast<int>(result_col);
-        } else if (static_cast<int>(result_col) != cols) {
-          // Insert the first occurance of this exact col count into the
-          // col count holder
-          cols_[static_cast<int>(result_col)] = 1;
-        }
-      }
-    }
+  // We can thus check to see if the founded corners fits into that window.
+  // The amount of frames of every corner position is precomputed once per
+  // resolution, so every corner is a lookup and an add per dimension.
+  rows_.SetSize(rows);
+  cols_.SetSize(cols);
+  for (const Corner& corner : corners) {
+    rows_.Vote(corner.row);
+    cols_.Vote(corner.col);
   }
 }
 
@@ -338,86 +218,46 @@ void FrameSizeEstimator::UpdateBestEstimateFrameSizes(int rows, int cols,
   //
   // This part of the algorithm thus detects whether the
   // values are all part of the maximum amount of frames i.e. 1,2,3,6 are all
-  // feasible values for a 6-column wide frame window
-
-  // Modulo the rows
-  std::map<int, int> result_row;
-  for (const auto& row_outer : rows_) {
-    result_row[row_outer.first] = 0;
-    // Modulo each row with the current row and sum
-    for (const auto& row_inner : rows_) {
-      int result = row_outer.first % row_inner.first;
-      result_row[row_outer.first] += result;
-    }
-  }
-  // The minimum row would be the most feasible (and divisible) option
-  auto row = std::min_element(
-      result_row.begin(), result_row.end(),
-      [this](const auto& l, const auto& r) {
-        // Weight the frequency with the modulo
-        float left = (1.f * l.second) / (1.f * rows_.find(l.first)->second);
-        float right = (1.f * r.second) / (1.f * rows_.find(r.first)->second);
-        return left < right;
-      });
-
-  // Modulo the cols
-  std::map<int, int> result_col;
-  for (const auto& col_outer : cols_) {
-    result_col[col_outer.first] = 0;
-
-    // Modulo each row with the current col and sum
-    for (const auto& col_inner : cols_) {
-      int result = col_outer.first % col_inner.first;
-      result_col[col_outer.first] += result;
-    }
-  }
-  // The minimum col would be the most feasible (and divisible) option
-  auto col = std::min_element(
-      result_col.begin(), result_col.end(),
-      [this](const auto& l, const auto& r) {
-        // Weight the frequency with the modulo
-        float left = (1.f * l.second) / (1.f * cols_.find(l.first)->second);
-        float right = (1.f * r.second) / (1.f * cols_.find(r.first)->second);
-        return left < right;
-      });
+  // feasible values for a 6-column wide frame window. The minimum modulo sum
+  // weighted with the frequency would be the most feasible option.
+  const int kRow = rows_.GetBestDivisor();
+  const int kCol = cols_.GetBestDivisor();
 
   if (export_images_) {
     // Print the rows
     std::cout << "Rows: ";
-    for (auto& r : rows_) {
-      if (r.first == row->first) {
+    for (int r : rows_.GetCandidates()) {
+      if (r == kRow) {
         std::cout << '*';
       }
-      std::cout << r.first << "[" << r.second
-                << ", mod_res: " << result_row.find(r.first)->second << "] ";
+      std::cout << r << "[" << rows_.GetVotes(r)
+                << ", mod_res: " << rows_.GetModuloSum(r) << "] ";
     }
     std::cout << std::endl;
 
     // Print the cols
     std::cout << "Columns: ";
-    for (auto& c : cols_) {
-      if (c.first == col->first) {
+    for (int c : cols_.GetCandidates()) {
+      if (c == kCol) {
         std::cout << '*';
       }
-      std::cout << c.first << "[" << c.second
-                << ", mod_res: " << result_col.find(c.first)->second << "] ";
+      std::cout << c << "[" << cols_.GetVotes(c)
+                << ", mod_res: " << cols_.GetModuloSum(c) << "] ";
     }
     std::cout << std::endl;
   }
 
-  // Boundary - Implement the confidence level here
-  int row_size = (rows_.find(row->first)->second >= boundary)
-                     ? (1.f * rows) / (1.f * row->first)
-                     : rows;
-  int col_size = (cols_.find(col->first)->second >= boundary)
-                     ? (1.f * cols) / (1.f * col->first)
-                     : cols;
+  // Boundary - Implement the confidence level here, no votes at all are below
+  // any boundary
+  const bool kRowFound = kRow > 0 && rows_.GetVotes(kRow) >= boundary;
+  const bool kColFound = kCol > 0 && cols_.GetVotes(kCol) >= boundary;
+  int row_size = kRowFound ? (1.f * rows) / (1.f * kRow) : rows;
+  int col_size = kColFound ? (1.f * cols) / (1.f * kCol) : cols;
 
   // A best estimate has been found if the cummulitive
   // sum of the selected row & col is larger than the
   // boundary
-  if (rows_.find(row->first)->second >= boundary &&
-      cols_.find(col->first)->second >= boundary) {
+  if (kRowFound && kColFound) {
     if (export_images_) {
       std::cout << "Found Best Estimate!" << std::endl;
     }
@@ -428,6 +268,18 @@ void FrameSizeEstimator::UpdateBestEstimateFrameSizes(int rows, int cols,
   frame_size_ = std::make_pair(col_size, row_size);
 }
 
+void FrameSizeEstimator::Merge(const Estimator& other) {
+  const FrameSizeEstimator& estimator =
+      dynamic_cast<const FrameSizeEstimator&>(other);
+  rows_.Merge(estimator.rows_);
+  cols_.Merge(estimator.cols_);
+
+  // The votes keep the size of the frames they were voted in
+  if (rows_.GetSize() > 0 && cols_.GetSize() > 0) {
+    UpdateBestEstimateFrameSizes(rows_.GetSize(), cols_.GetSize(), 5);
+  }
+}
+
 std::pair<int, int> FrameSizeEstimator::GetBestEstimateFrameSize() {
   return frame_size_;
 }
@@ -0,0 +1,71 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#include "video-detect/grid_estimator.h"
+
+#include <iostream>
+#include <typeinfo>
+
+namespace video_detect {
+
+GridEstimator::GridEstimator(bool print_votes, int confidence_level,
+                             int max_grid_size)
+    : print_votes_(print_votes),
+      confidence_level_(confidence_level),
+      max_grid_size_(max_grid_size),
+      votes_(max_grid_size),
+      image_size_(0, 0),
+      frame_size_(0, 0),
+      best_estimate_found_(false) {}
+
+void GridEstimator::Vote(const mat::Mat2D<uint8_t> &mat, int rows, int cols) {
+  votes_.Vote(rows, cols);
+  image_size_ = std::make_pair(mat.GetRowCount(), mat.GetColCount());
+  UpdateBestEstimateFrameSize(image_size_.first, image_size_.second);
+}
+
+void GridEstimator::UpdateBestEstimateFrameSize(int rows, int cols) {
+  const int kRowCount = votes_.GetRowCount();
+  const int kColCount = votes_.GetColCount();
+
+  if (print_votes_) {
+    std::cout << "Rows: " << kRowCount << "[" << votes_.GetRowVotes(kRowCount)
+              << "] Columns: " << kColCount << "["
+              << votes_.GetColVotes(kColCount) << "]";
+    PrintVoteDetails();
+    std::cout << std::endl;
+  }
+
+  // A best estimate has been found if enough frames voted for it
+  if (votes_.GetRowVotes(kRowCount) >= confidence_level_ &&
+      votes_.GetColVotes(kColCount) >= confidence_level_) {
+    if (print_votes_ && !best_estimate_found_) {
+      std::cout << "Found Best Estimate!" << std::endl;
+    }
+    best_estimate_found_ = true;
+  }
+
+  frame_size_ = std::make_pair(cols / kColCount, rows / kRowCount);
+}
+
+void GridEstimator::Merge(const Estimator &other) {
+  // Only the votes of the same engine count the same grids
+  if (typeid(other) != typeid(*this)) {
+    throw std::bad_cast();
+  }
+  const GridEstimator &estimator = static_cast<const GridEstimator &>(other);
+  votes_.Merge(estimator.votes_);
+  if (image_size_.first == 0) {
+    image_size_ = estimator.image_size_;
+  }
+  if (image_size_.first > 0) {
+    UpdateBestEstimateFrameSize(image_size_.first, image_size_.second);
+  }
+}
+
+std::pair<int, int> GridEstimator::GetBestEstimateFrameSize() {
+  return frame_size_;
+}
+
+}  // namespace video_detect
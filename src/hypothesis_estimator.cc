@@ -0,0 +1,137 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#include "video-detect/hypothesis_estimator.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+
+namespace video_detect {
+
+constexpr float HypothesisEstimator::kMinStrength;
+
+namespace {
+
+// The amount of pixels sampled along a line
+constexpr int kLineSamples = 256;
+
+}  // namespace
+
+HypothesisEstimator::HypothesisEstimator(bool print_votes,
+                                         int confidence_level,
+                                         int max_grid_size, float margin)
+    : GridEstimator(print_votes, confidence_level, max_grid_size),
+      margin_(margin) {}
+
+void HypothesisEstimator::Accept(const mat::Mat2D<uint8_t> &mat) {
+  read_count_ = 0;
+
+  // 1. Check the grids along the height and the width, starting with the
+  //    grid voted for most so far
+  const int kRowCount =
+      FindGridCount(mat, Axis::kRows, GetVotes().GetRowCount());
+  const int kColCount =
+      FindGridCount(mat, Axis::kCols, GetVotes().GetColCount());
+
+  // 2. Vote for the grid and update the best estimate frame size
+  Vote(mat, kRowCount, kColCount);
+}
+
+void HypothesisEstimator::PrintVoteDetails() const {
+  std::cout << " Reads: " << read_count_;
+}
+
+float HypothesisEstimator::GetLineStrength(mat::Mat2DView<const uint8_t> mat,
+                                           Axis axis, int position) {
+  const int kLength =
+      axis == Axis::kRows ? mat.GetColCount() : mat.GetRowCount();
+  const int kStep = std::max(1, kLength / kLineSamples);
+
+  int sum = 0;
+  int samples = 0;
+  if (axis == Axis::kRows) {
+    const uint8_t *above = mat.GetRowPtr(position - 1);
+    const uint8_t *src = mat.GetRowPtr(position);
+    for (int col = 0; col < kLength; col += kStep, samples++) {
+      sum += std::abs(src[col] - above[col]);
+    }
+  } else {
+    for (int row = 0; row < kLength; row += kStep, samples++) {
+      const uint8_t *src = mat.GetRowPtr(row) + position;
+      sum += std::abs(src[0] - src[-1]);
+    }
+  }
+  read_count_ += 2 * samples;
+  return (1.f * sum) / (1.f * samples);
+}
+
+int HypothesisEstimator::FindGridCount(mat::Mat2DView<const uint8_t> mat,
+                                       Axis axis, int hint) {
+  const int kSize =
+      axis == Axis::kRows ? mat.GetRowCount() : mat.GetColCount();
+
+  // Every frame must be at least a few lines apart
+  const int kMaxCount = std::min(GetMaxGridSize(), kSize / 8);
+  if (hint > 1 && hint <= kMaxCount && IsGridCount(mat, axis, hint)) {
+    // A divisor of the grid wins as well, so the largest multiple of the hint
+    // that wins is the grid
+    for (int count = kMaxCount / hint * hint; count > hint; count -= hint) {
+      if (IsGridCount(mat, axis, count)) {
+        return count;
+      }
+    }
+    return hint;
+  }
+
+  // The boundaries of a grid include those of its divisors, so the largest
+  // amount that wins is the grid
+  for (int count = kMaxCount; count > 1; count--) {
+    if (count != hint && IsGridCount(mat, axis, count)) {
+      return count;
+    }
+  }
+  return 1;
+}
+
+bool HypothesisEstimator::IsGridCount(mat::Mat2DView<const uint8_t> mat,
+                                      Axis axis, int count) {
+  const int kSize =
+      axis == Axis::kRows ? mat.GetRowCount() : mat.GetColCount();
+
+  // A boundary may be a pixel off and have an edge on either side
+  const int kTolerance = std::max(1, kSize / 256);
+
+  // Alternate between the control line of a frame and the boundary after it,
+  // the grid is rejected as soon as the weakest boundary so far is not
+  // stronger than the strongest control line so far by the margin
+  float control = kMinStrength / margin_;
+  float boundary = std::numeric_limits<float>::max();
+  for (int k = 0; k < count; k++) {
+    const int kControl = ((2 * k + 1) * kSize + count) / (2 * count);
+    control = std::max(control, GetLineStrength(mat, axis, kControl));
+    if (boundary < margin_ * control) {
+      return false;
+    }
+    if (k == count - 1) {
+      break;
+    }
+
+    const int kCenter = ((k + 1) * kSize + count / 2) / count;
+    const int kBegin = std::max(kCenter - kTolerance, 1);
+    const int kEnd = std::min(kCenter + kTolerance, kSize - 1);
+    float peak = 0.f;
+    for (int position = kBegin; position <= kEnd; position++) {
+      peak = std::max(peak, GetLineStrength(mat, axis, position));
+    }
+    boundary = std::min(boundary, peak);
+    if (boundary < margin_ * control) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace video_detect
@@ -2,14 +2,111 @@
  * MIT License Copyright (c) 2021 CppEngineer
  */
 
+#include <algorithm>
+#include <chrono>
 #include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
 
 #include "video-detect/ffmpeg/ff2cv.h"
 #include "video-detect/frame_size_estimator.h"
+#include "video-detect/hypothesis_estimator.h"
 #include "video-detect/mat_bridge.h"
 #include "video-detect/options.h"
+#include "video-detect/profile_estimator.h"
+#include "video-detect/util/thread_pool.h"
 #include "video-detect/util/worker.h"
 
+namespace {
+
+/**
+ * @brief Create the estimator of the engine selected in the options
+ */
+std::unique_ptr<video_detect::Estimator> CreateEstimator(
+    const video_detect::Options &options) {
+  typedef video_detect::Options::Engine Engine;
+  std::unique_ptr<video_detect::Estimator> estimator;
+  if (options.GetEngine() == Engine::kProfile) {
+    estimator.reset(new video_detect::ProfileEstimator(
+        options.IsExportImages(), options.GetConfidenceLevel(),
+        options.GetMaxGridSize()));
+  } else if (options.GetEngine() == Engine::kHypothesis) {
+    estimator.reset(new video_detect::HypothesisEstimator(
+        options.IsExportImages(), options.GetConfidenceLevel(),
+        options.GetMaxGridSize(), options.GetMargin()));
+  } else {
+    estimator.reset(new video_detect::FrameSizeEstimator(
+        options.IsExportImages(), options.GetOutputPath(),
+        options.GetConfidenceLevel(), options.GetMaxGridSize()));
+  }
+  return estimator;
+}
+
+/**
+ * @brief Wait for the worker to finish its work, the remaining work is
+ * cancelled as soon as the estimator has found a best estimate
+ */
+void WaitForWorker(video_detect::util::Worker *worker,
+                   const video_detect::Estimator &estimator) {
+  while (worker->IsBusy()) {
+    // If a best estimate has been found then cancel the remaining work
+    if (estimator.HasBestEstimate()) {
+      worker->CancelWork();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+
+/**
+ * @brief Read the segments of the video in parallel, every segment with its
+ * own decoder, worker and estimator, and merge the votes of all segments into
+ * the estimator
+ *
+ * @return int 0 if all segments were read, else the error of a segment
+ */
+int ReadSegments(const video_detect::Options &options,
+                 const video_detect::ffmpeg::DecoderSettings &decoder_settings,
+                 video_detect::Estimator *estimator) {
+  const int kSegmentCount = options.GetSegmentCount();
+  std::vector<std::unique_ptr<video_detect::Estimator>> estimators;
+  std::vector<std::unique_ptr<video_detect::util::Worker>> workers;
+  std::vector<std::unique_ptr<video_detect::MatBridge>> mat_bridges;
+  for (int i = 0; i < kSegmentCount; i++) {
+    estimators.push_back(CreateEstimator(options));
+    workers.push_back(std::make_unique<video_detect::util::Worker>());
+    mat_bridges.push_back(std::make_unique<video_detect::MatBridge>(
+        *workers.back(), *estimators.back()));
+  }
+
+  // Decode and analyse every segment on its own thread
+  std::vector<int> results(kSegmentCount, 0);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kSegmentCount; i++) {
+    threads.emplace_back([&, i] {
+      results[i] = video_detect::ffmpeg::ff2cv_segment(
+          options.GetFileInput().c_str(), options.GetFrameModulo(), i,
+          kSegmentCount, decoder_settings, mat_bridges[i].get());
+      WaitForWorker(workers[i].get(), *estimators[i]);
+    });
+  }
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+
+  // Merge the votes of the segments, the order does not matter
+  int result = 0;
+  for (int i = 0; i < kSegmentCount; i++) {
+    estimator->Merge(*estimators[i]);
+    if (results[i] != 0) {
+      result = results[i];
+    }
+  }
+  return result;
+}
+
+}  // namespace
+
 /**
  * @brief Application main entry point.
  *
@@ -26,33 +123,57 @@ int main(int argc, const char *argv[]) {
   video_detect::Options options;
   options.Parse(argc, argv);
 
+  // Set the amount of threads the frames are analyzed with
+  video_detect::util::SetThreadCount(options.GetThreadCount());
+
   // Create a single threaded worker for executing work in the program
   video_detect::util::Worker worker;
 
-  // Create a FrameSizeEstimator
-  video_detect::FrameSizeEstimator frame_size_estimator(
-      options.IsExportImages(), options.GetOutputPath(),
-      options.GetConfidenceLevel());
+  // Create the estimator of the selected engine
+  std::unique_ptr<video_detect::Estimator> estimator = CreateEstimator(options);
+  video_detect::Estimator &frame_size_estimator = *estimator;
 
   // Create a matrix bridge between the external code for reading in the video
   // files and our program
   video_detect::MatBridge mat_bridge(worker, frame_size_estimator);
 
+  // Set up the decoder
+  video_detect::ffmpeg::DecoderSettings decoder_settings;
+  decoder_settings.frame_skip = options.GetFrameSkip();
+  decoder_settings.thread_count = options.GetDecodeThreadCount();
+  decoder_settings.threading = options.GetDecodeThreading();
+
+  // The segments share the hardware threads when the decoders pick their
+  // amount of threads
+  const int kSegmentCount = options.GetSegmentCount();
+  if (kSegmentCount > 1 && decoder_settings.thread_count == 0) {
+    decoder_settings.thread_count = std::max(
+        1, static_cast<int>(std::thread::hardware_concurrency()) /
+               kSegmentCount);
+  }
+
   // Read the video and analyse the frames, send the frames to the
-  // matrix bridge
-  if (video_detect::ffmpeg::ff2cv(options.GetFileInput().c_str(),
-                                  options.GetFrameModulo(), &mat_bridge) != 0) {
+  // matrix bridge. When sampling, only the frames at the sampled timestamps
+  // are decoded. Segments are read in parallel, each into its own estimator.
+  int read_result = 0;
+  if (kSegmentCount > 1) {
+    read_result = ReadSegments(options, decoder_settings, estimator.get());
+  } else if (options.IsSampling()) {
+    read_result = video_detect::ffmpeg::ff2cv_sampled(
+        options.GetFileInput().c_str(), options.GetSampleInterval(),
+        options.GetSampleCount(), decoder_settings, &mat_bridge);
+  } else {
+    read_result = video_detect::ffmpeg::ff2cv(
+        options.GetFileInput().c_str(), options.GetFrameModulo(),
+        decoder_settings, &mat_bridge);
+  }
+  if (read_result != 0) {
     std::cout << "Error in loading video!" << std::endl;
     exit(EXIT_FAILURE);
   }
 
   // Wait for worker to finish its work
-  while (worker.IsBusy()) {
-    // If a best estimate has been found then cancel the remaining work
-    if (frame_size_estimator.HasBestEstimate()) {
-      worker.CancelWork();
-    }
-  }
+  WaitForWorker(&worker, frame_size_estimator);
 
   // Print the best estimate frame size
   bool result = frame_size_estimator.HasBestEstimate();
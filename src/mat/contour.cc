@@ -0,0 +1,61 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#include "video-detect/mat/contour.h"
+
+#include "video-detect/util/thread_pool.h"
+
+namespace video_detect {
+namespace mat {
+
+namespace {
+
+/**
+ * Mark the boundary pixels of one row. The rows above and below are nullptr
+ * outside the source, which makes every non-zero value of the row a boundary
+ * pixel. The interior columns are calculated without branches such that the
+ * compiler can vectorize the loop.
+ */
+void ContourMaskRow(const uint8_t *above, const uint8_t *center,
+                    const uint8_t *below, int cols, uint8_t *dst) {
+  if (above == nullptr || below == nullptr) {
+    for (int col = 0; col < cols; col++) {
+      dst[col] = center[col] != 0 ? 255 : 0;
+    }
+    return;
+  }
+
+  for (int col = 1; col < cols - 1; col++) {
+    const bool kOpen = above[col] == 0 || below[col] == 0 ||
+                       center[col - 1] == 0 || center[col + 1] == 0;
+    dst[col] = (center[col] != 0 && kOpen) ? 255 : 0;
+  }
+
+  // The first and last columns touch the edge of the source
+  dst[0] = center[0] != 0 ? 255 : 0;
+  dst[cols - 1] = center[cols - 1] != 0 ? 255 : 0;
+}
+
+}  // namespace
+
+void ContourMask(Mat2DView<const uint8_t> mat, Mat2DView<uint8_t> result) {
+  const int rows = mat.GetRowCount();
+  const int cols = mat.GetColCount();
+  if (rows <= 0 || cols <= 0) {
+    return;
+  }
+
+  util::ParallelForRows(rows, cols, [&](int row_begin, int row_end) {
+    for (int row = row_begin; row < row_end; row++) {
+      const uint8_t *above = row > 0 ? mat.GetRowPtr(row - 1) : nullptr;
+      const uint8_t *below =
+          row < rows - 1 ? mat.GetRowPtr(row + 1) : nullptr;
+      ContourMaskRow(above, mat.GetRowPtr(row), below, cols,
+                     result.GetRowPtr(row));
+    }
+  });
+}
+
+}  // namespace mat
+}  // namespace video_detect
@@ -0,0 +1,247 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#include "video-detect/mat/conv_u8.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "video-detect/util/cpu_features.h"
+#include "video-detect/util/thread_pool.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define VIDEO_DETECT_CONV_U8_X86
+#include <immintrin.h>
+#endif
+
+namespace video_detect {
+namespace mat {
+
+constexpr int FixedPointKernel::kMaxShift;
+
+namespace {
+
+typedef void (*ConvU8Row)(Mat2DView<const uint8_t> mat,
+                          const FixedPointKernel &kernel, int row,
+                          int col_begin, int col_end, uint8_t *dst);
+
+/**
+ * Saturate a shifted sum to the uint8 range
+ */
+inline uint8_t SaturateU8(int32_t value) {
+  return static_cast<uint8_t>(std::max(0, std::min(255, value)));
+}
+
+/**
+ * Calculate a single value with bounds checks, this is the reference for all
+ * the paths and is used for the borders of the image
+ */
+inline uint8_t ConvU8Value(Mat2DView<const uint8_t> mat,
+                           const FixedPointKernel &kernel, int row, int col) {
+  const Mat2D<int16_t> &weights = kernel.GetWeights();
+  const int kRowOffset = weights.GetRowCount() / 2;
+  const int kColOffset = weights.GetColCount() / 2;
+
+  int32_t sum = 0;
+  for (int y = 0; y < weights.GetRowCount(); y++) {
+    const int kRowTarget = row - kRowOffset + y;
+    if (kRowTarget < 0 || kRowTarget >= mat.GetRowCount()) {
+      continue;
+    }
+    const uint8_t *src = mat.GetRowPtr(kRowTarget);
+    for (int x = 0; x < weights.GetColCount(); x++) {
+      const int kColTarget = col - kColOffset + x;
+      if (kColTarget >= 0 && kColTarget < mat.GetColCount()) {
+        sum += src[kColTarget] * weights.At(y, x);
+      }
+    }
+  }
+  return SaturateU8(sum >> kernel.GetShift());
+}
+
+void ConvU8RowScalar(Mat2DView<const uint8_t> mat,
+                     const FixedPointKernel &kernel, int row, int col_begin,
+                     int col_end, uint8_t *dst) {
+  for (int col = col_begin; col < col_end; col++) {
+    dst[col] = ConvU8Value(mat, kernel, row, col);
+  }
+}
+
+#ifdef VIDEO_DETECT_CONV_U8_X86
+
+__attribute__((target("sse4.1"))) void ConvU8RowSse41(
+    Mat2DView<const uint8_t> mat, const FixedPointKernel &kernel, int row,
+    int col_begin, int col_end, uint8_t *dst) {
+  const Mat2D<int16_t> &weights = kernel.GetWeights();
+  const int kRowOffset = weights.GetRowCount() / 2;
+  const int kColOffset = weights.GetColCount() / 2;
+  const __m128i kShift = _mm_cvtsi32_si128(kernel.GetShift());
+  const __m128i kZero = _mm_setzero_si128();
+  const __m128i kMax = _mm_set1_epi32(255);
+
+  // Four values at a time, all the columns of the kernel are in bounds
+  int col = col_begin;
+  for (; col + 4 <= col_end; col += 4) {
+    __m128i sum = _mm_setzero_si128();
+    for (int y = 0; y < weights.GetRowCount(); y++) {
+      const int kRowTarget = row - kRowOffset + y;
+      if (kRowTarget < 0 || kRowTarget >= mat.GetRowCount()) {
+        continue;
+      }
+      const uint8_t *src = mat.GetRowPtr(kRowTarget) + col - kColOffset;
+      for (int x = 0; x < weights.GetColCount(); x++) {
+        const int16_t kWeight = weights.At(y, x);
+        if (kWeight == 0) {
+          continue;
+        }
+        int32_t packed;
+        std::memcpy(&packed, src + x, sizeof(packed));
+        const __m128i kValues = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(packed));
+        sum = _mm_add_epi32(sum,
+                            _mm_mullo_epi32(kValues, _mm_set1_epi32(kWeight)));
+      }
+    }
+
+    // Shift, saturate and store
+    sum = _mm_min_epi32(_mm_max_epi32(_mm_sra_epi32(sum, kShift), kZero), kMax);
+    const __m128i kPacked = _mm_packus_epi16(_mm_packs_epi32(sum, sum), kZero);
+    const int32_t kResult = _mm_cvtsi128_si32(kPacked);
+    std::memcpy(dst + col, &kResult, sizeof(kResult));
+  }
+  ConvU8RowScalar(mat, kernel, row, col, col_end, dst);
+}
+
+__attribute__((target("avx2"))) void ConvU8RowAvx2(
+    Mat2DView<const uint8_t> mat, const FixedPointKernel &kernel, int row,
+    int col_begin, int col_end, uint8_t *dst) {
+  const Mat2D<int16_t> &weights = kernel.GetWeights();
+  const int kRowOffset = weights.GetRowCount() / 2;
+  const int kColOffset = weights.GetColCount() / 2;
+  const __m128i kShift = _mm_cvtsi32_si128(kernel.GetShift());
+  const __m256i kZero = _mm256_setzero_si256();
+  const __m256i kMax = _mm256_set1_epi32(255);
+
+  // Eight values at a time, all the columns of the kernel are in bounds
+  int col = col_begin;
+  for (; col + 8 <= col_end; col += 8) {
+    __m256i sum = _mm256_setzero_si256();
+    for (int y = 0; y < weights.GetRowCount(); y++) {
+      const int kRowTarget = row - kRowOffset + y;
+      if (kRowTarget < 0 || kRowTarget >= mat.GetRowCount()) {
+        continue;
+      }
+      const uint8_t *src = mat.GetRowPtr(kRowTarget) + col - kColOffset;
+      for (int x = 0; x < weights.GetColCount(); x++) {
+        const int16_t kWeight = weights.At(y, x);
+        if (kWeight == 0) {
+          continue;
+        }
+        const __m256i kValues = _mm256_cvtepu8_epi32(
+            _mm_loadl_epi64(reinterpret_cast<const __m128i *>(src + x)));
+        sum = _mm256_add_epi32(
+            sum, _mm256_mullo_epi32(kValues, _mm256_set1_epi32(kWeight)));
+      }
+    }
+
+    // Shift, saturate and store
+    sum = _mm256_min_epi32(
+        _mm256_max_epi32(_mm256_sra_epi32(sum, kShift), kZero), kMax);
+    const __m128i kWords = _mm_packs_epi32(_mm256_castsi256_si128(sum),
+                                           _mm256_extracti128_si256(sum, 1));
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(dst + col),
+                     _mm_packus_epi16(kWords, kWords));
+  }
+  ConvU8RowScalar(mat, kernel, row, col, col_end, dst);
+}
+
+#endif  // VIDEO_DETECT_CONV_U8_X86
+
+ConvU8Row GetConvU8Row(ConvPath path) {
+#ifdef VIDEO_DETECT_CONV_U8_X86
+  switch (path) {
+    case ConvPath::kAvx2:
+      return ConvU8RowAvx2;
+    case ConvPath::kSse41:
+      return ConvU8RowSse41;
+    default:
+      break;
+  }
+#endif
+  return ConvU8RowScalar;
+}
+
+ConvPath SelectConvPath() {
+  if (IsConvPathSupported(ConvPath::kAvx2)) {
+    return ConvPath::kAvx2;
+  }
+  if (IsConvPathSupported(ConvPath::kSse41)) {
+    return ConvPath::kSse41;
+  }
+  return ConvPath::kScalar;
+}
+
+}  // namespace
+
+bool IsConvPathSupported(ConvPath path) {
+#ifdef VIDEO_DETECT_CONV_U8_X86
+  switch (path) {
+    case ConvPath::kAvx2:
+      return util::GetCpuFeatures().avx2;
+    case ConvPath::kSse41:
+      return util::GetCpuFeatures().sse41;
+    default:
+      break;
+  }
+#endif
+  return path == ConvPath::kScalar;
+}
+
+ConvPath GetDefaultConvPath() {
+  static const ConvPath kPath = SelectConvPath();
+  return kPath;
+}
+
+void ConvU8(Mat2DView<const uint8_t> mat, const FixedPointKernel &kernel,
+            Mat2DView<uint8_t> result) {
+  ConvU8(mat, kernel, result, GetDefaultConvPath());
+}
+
+void ConvU8(Mat2DView<const uint8_t> mat, const FixedPointKernel &kernel,
+            Mat2DView<uint8_t> result, ConvPath path) {
+  // The bands read their neighbouring rows from the whole source
+  util::ParallelForRows(
+      mat.GetRowCount(), mat.GetColCount(), [&](int row_begin, int row_end) {
+        ConvU8Rows(mat, kernel, row_begin, row_end,
+                   result.SliceRows(row_begin, row_end - row_begin), path);
+      });
+}
+
+void ConvU8Rows(Mat2DView<const uint8_t> mat, const FixedPointKernel &kernel,
+                int row_begin, int row_end, Mat2DView<uint8_t> result) {
+  ConvU8Rows(mat, kernel, row_begin, row_end, result, GetDefaultConvPath());
+}
+
+void ConvU8Rows(Mat2DView<const uint8_t> mat, const FixedPointKernel &kernel,
+                int row_begin, int row_end, Mat2DView<uint8_t> result,
+                ConvPath path) {
+  const ConvU8Row kConvRow = GetConvU8Row(path);
+  const int kCols = mat.GetColCount();
+  const int kColOffset = kernel.GetWeights().GetColCount() / 2;
+
+  // The columns for which the whole kernel row is inside the bounds
+  const int kInnerBegin = std::min(kColOffset, kCols);
+  const int kInnerEnd = std::max(
+      kInnerBegin,
+      kCols - (kernel.GetWeights().GetColCount() - 1 - kColOffset));
+
+  for (int row = row_begin; row < row_end; row++) {
+    uint8_t *dst = result.GetRowPtr(row - row_begin);
+    ConvU8RowScalar(mat, kernel, row, 0, kInnerBegin, dst);
+    kConvRow(mat, kernel, row, kInnerBegin, kInnerEnd, dst);
+    ConvU8RowScalar(mat, kernel, row, kInnerEnd, kCols, dst);
+  }
+}
+
+}  // namespace mat
+}  // namespace video_detect
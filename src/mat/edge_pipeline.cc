@@ -0,0 +1,71 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#include "video-detect/mat/edge_pipeline.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "video-detect/util/thread_pool.h"
+
+namespace video_detect {
+namespace mat {
+
+void EdgePipeline::Apply(Mat2DView<const uint8_t> mat,
+                         Mat2DView<uint8_t> magnitude) const {
+  // Every band recalculates the smoothed rows just outside of it
+  util::ParallelForRows(
+      mat.GetRowCount(), mat.GetColCount(), [&](int row_begin, int row_end) {
+        ApplyRows(mat, row_begin, row_end,
+                  magnitude.SliceRows(row_begin, row_end - row_begin));
+      });
+}
+
+void EdgePipeline::ApplyRows(Mat2DView<const uint8_t> mat, int row_begin,
+                             int row_end, Mat2DView<uint8_t> magnitude) const {
+  const int kRows = mat.GetRowCount();
+  const int kCols = mat.GetColCount();
+  row_begin = std::max(row_begin, 0);
+  row_end = std::min(row_end, kRows);
+  if (row_begin >= row_end || kCols <= 0) {
+    return;
+  }
+
+  // The rolling buffer of three smoothed and thresholded rows, row y is kept
+  // in line y % 3. The buffer is kept per thread and only grows.
+  static const int kLines = 3;
+  static thread_local std::vector<uint8_t> buffer;
+  buffer.resize(std::max<std::size_t>(buffer.size(), kLines * kCols));
+  Mat2DView<uint8_t> lines(buffer.data(), kLines, kCols, kCols);
+
+  // Filter one source row into its line of the buffer
+  auto filter_row = [&](int row) {
+    Mat2DView<uint8_t> line = lines.SliceRows(row % kLines, 1);
+    ConvU8Rows(mat, gaussian_, row, row + 1, line);
+    threshold_.ApplyRows(line);
+  };
+
+  // Fill the buffer with the rows above and at the first row
+  for (int row = std::max(row_begin - 1, 0); row <= row_begin; row++) {
+    filter_row(row);
+  }
+
+  for (int row = row_begin; row < row_end; row++) {
+    // Bring the row below into the buffer, replacing the row above the
+    // previous row
+    if (row + 1 < kRows) {
+      filter_row(row + 1);
+    }
+
+    const uint8_t *above =
+        row > 0 ? lines.GetRowPtr((row - 1) % kLines) : nullptr;
+    const uint8_t *below =
+        row + 1 < kRows ? lines.GetRowPtr((row + 1) % kLines) : nullptr;
+    SobelGradientRow(above, lines.GetRowPtr(row % kLines), below, kCols,
+                     magnitude.GetRowPtr(row - row_begin), nullptr, norm_);
+  }
+}
+
+}  // namespace mat
+}  // namespace video_detect
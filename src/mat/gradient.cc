@@ -0,0 +1,139 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#include "video-detect/mat/gradient.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+#include "video-detect/util/thread_pool.h"
+
+namespace video_detect {
+namespace mat {
+
+namespace {
+
+/**
+ * Calculate the gradients of one row from the rows above, at and below it.
+ * The interior columns are calculated without checks such that the compiler
+ * can vectorize the loop.
+ */
+void SobelRow(const uint8_t *above, const uint8_t *center,
+              const uint8_t *below, int cols, int16_t *gx, int16_t *gy) {
+  for (int col = 1; col < cols - 1; col++) {
+    gx[col] = static_cast<int16_t>(
+        (above[col + 1] - above[col - 1]) +
+        2 * (center[col + 1] - center[col - 1]) +
+        (below[col + 1] - below[col - 1]));
+    gy[col] = static_cast<int16_t>(
+        (above[col - 1] + 2 * above[col] + above[col + 1]) -
+        (below[col - 1] + 2 * below[col] + below[col + 1]));
+  }
+
+  // The first and last columns, values outside are zero
+  for (int col : {0, cols - 1}) {
+    auto value = [cols](const uint8_t *row, int index) {
+      return index >= 0 && index < cols ? row[index] : 0;
+    };
+    gx[col] = static_cast<int16_t>(
+        (value(above, col + 1) - value(above, col - 1)) +
+        2 * (value(center, col + 1) - value(center, col - 1)) +
+        (value(below, col + 1) - value(below, col - 1)));
+    gy[col] = static_cast<int16_t>(
+        (value(above, col - 1) + 2 * value(above, col) +
+         value(above, col + 1)) -
+        (value(below, col - 1) + 2 * value(below, col) +
+         value(below, col + 1)));
+  }
+}
+
+void MagnitudeL1(const int16_t *gx, const int16_t *gy, int cols,
+                 uint8_t *magnitude) {
+  for (int col = 0; col < cols; col++) {
+    const int kSum = std::abs(gx[col]) + std::abs(gy[col]);
+    magnitude[col] = static_cast<uint8_t>(std::min(kSum, 255));
+  }
+}
+
+void MagnitudeL2(const int16_t *gx, const int16_t *gy, int cols,
+                 uint8_t *magnitude) {
+  for (int col = 0; col < cols; col++) {
+    // The squared magnitude fits in int32, the single precision square root
+    // of an integer below 2^24 rounds down to the integer square root
+    const int kSquared = gx[col] * gx[col] + gy[col] * gy[col];
+    const int kSaturated = std::min(kSquared, 255 * 255);
+    magnitude[col] = static_cast<uint8_t>(std::sqrt(1.f * kSaturated));
+  }
+}
+
+void Direction(const int16_t *gx, const int16_t *gy, int cols,
+               uint8_t *direction) {
+  static const double kScale = 128.0 / std::acos(-1.0);
+  for (int col = 0; col < cols; col++) {
+    const long kSteps =  // NOLINT(runtime/int)
+        std::lround(std::atan2(gy[col], gx[col]) * kScale);
+    direction[col] = static_cast<uint8_t>(kSteps & 0xFF);
+  }
+}
+
+}  // namespace
+
+void SobelGradient(Mat2DView<const uint8_t> mat, Mat2DView<uint8_t> magnitude,
+                   GradientNorm norm) {
+  SobelGradient(mat, magnitude, Mat2DView<uint8_t>(), norm);
+}
+
+void SobelGradient(Mat2DView<const uint8_t> mat, Mat2DView<uint8_t> magnitude,
+                   Mat2DView<uint8_t> direction, GradientNorm norm) {
+  const int rows = mat.GetRowCount();
+  const int cols = mat.GetColCount();
+  if (rows <= 0 || cols <= 0) {
+    return;
+  }
+
+  util::ParallelForRows(rows, cols, [&](int row_begin, int row_end) {
+    for (int row = row_begin; row < row_end; row++) {
+      const uint8_t *above = row > 0 ? mat.GetRowPtr(row - 1) : nullptr;
+      const uint8_t *below =
+          row < rows - 1 ? mat.GetRowPtr(row + 1) : nullptr;
+      uint8_t *direction_row =
+          direction.IsEmpty() ? nullptr : direction.GetRowPtr(row);
+      SobelGradientRow(above, mat.GetRowPtr(row), below, cols,
+                       magnitude.GetRowPtr(row), direction_row, norm);
+    }
+  });
+}
+
+void SobelGradientRow(const uint8_t *above, const uint8_t *center,
+                      const uint8_t *below, int cols, uint8_t *magnitude,
+                      uint8_t *direction, GradientNorm norm) {
+  if (cols <= 0) {
+    return;
+  }
+
+  // The gradients of one row and a zero row for above the first and below the
+  // last row. The buffers are kept per thread and only grow.
+  static thread_local std::vector<int16_t> gradients;
+  static thread_local std::vector<uint8_t> zeroes;
+  gradients.resize(std::max<std::size_t>(gradients.size(), 2 * cols));
+  zeroes.resize(std::max<std::size_t>(zeroes.size(), cols));
+  int16_t *gx = gradients.data();
+  int16_t *gy = gradients.data() + cols;
+
+  SobelRow(above != nullptr ? above : zeroes.data(), center,
+           below != nullptr ? below : zeroes.data(), cols, gx, gy);
+  if (norm == GradientNorm::kL1) {
+    MagnitudeL1(gx, gy, cols, magnitude);
+  } else {
+    MagnitudeL2(gx, gy, cols, magnitude);
+  }
+  if (direction != nullptr) {
+    Direction(gx, gy, cols, direction);
+  }
+}
+
+}  // namespace mat
+}  // namespace video_detect
@@ -0,0 +1,157 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#include "video-detect/mat/line_features.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "video-detect/util/thread_pool.h"
+
+namespace video_detect {
+namespace mat {
+
+namespace {
+
+constexpr uint8_t kLineValue = 255;
+
+/**
+ * Add the line values of a row to the counts of the columns (sign 1) or
+ * remove them (sign -1)
+ */
+void AddRowCounts(const uint8_t *src, int cols, int sign, int *counts) {
+  for (int col = 0; col < cols; col++) {
+    counts[col] += sign * (src[col] == kLineValue);
+  }
+}
+
+/**
+ * Mark the crossings of one row given the vertical counts of its columns
+ */
+void FindRowCrossings(const uint8_t *src, const int *counts, int cols,
+                      int radius, int min_count, uint8_t *dst) {
+  // The horizontal count of the window around the first column
+  int count = 0;
+  for (int col = 0; col <= std::min(radius, cols - 1); col++) {
+    count += src[col] == kLineValue;
+  }
+
+  for (int col = 0; col < cols; col++) {
+    const bool kCrossing = count >= min_count && counts[col] >= min_count;
+    dst[col] = kCrossing ? kLineValue : 0;
+
+    // Slide the window one column to the right
+    if (col + 1 + radius < cols) {
+      count += src[col + 1 + radius] == kLineValue;
+    }
+    if (col - radius >= 0) {
+      count -= src[col - radius] == kLineValue;
+    }
+  }
+}
+
+}  // namespace
+
+void FindLineCrossings(Mat2DView<const uint8_t> mat, int radius,
+                       int min_count, Mat2DView<uint8_t> result) {
+  const int rows = mat.GetRowCount();
+  const int cols = mat.GetColCount();
+  if (rows <= 0 || cols <= 0) {
+    return;
+  }
+
+  util::ParallelForRows(rows, cols, [&](int row_begin, int row_end) {
+    // The vertical counts of the window around the current row for every
+    // column. The buffer is kept per thread and only grows.
+    static thread_local std::vector<int> buffer;
+    buffer.resize(std::max<std::size_t>(buffer.size(), cols));
+    int *counts = buffer.data();
+    std::fill(counts, counts + cols, 0);
+    for (int row = std::max(row_begin - radius, 0);
+         row <= std::min(row_begin + radius, rows - 1); row++) {
+      AddRowCounts(mat.GetRowPtr(row), cols, 1, counts);
+    }
+
+    for (int row = row_begin; row < row_end; row++) {
+      FindRowCrossings(mat.GetRowPtr(row), counts, cols, radius, min_count,
+                       result.GetRowPtr(row));
+
+      // Slide the window one row down
+      if (row + 1 + radius < rows) {
+        AddRowCounts(mat.GetRowPtr(row + 1 + radius), cols, 1, counts);
+      }
+      if (row - radius >= 0) {
+        AddRowCounts(mat.GetRowPtr(row - radius), cols, -1, counts);
+      }
+    }
+  });
+}
+
+void LineFeatureFinder::Apply(Mat2DView<const uint8_t> mat,
+                              Mat2DView<uint8_t> mask) {
+  const int rows = mat.GetRowCount();
+  const int cols = mat.GetColCount();
+  horizontal_lines_.clear();
+  vertical_lines_.clear();
+  column_runs_.assign(std::max(cols, 0), 0);
+
+  for (int row = 0; row < rows; row++) {
+    const uint8_t *src = mat.GetRowPtr(row);
+    uint8_t *dst = mask.GetRowPtr(row);
+    std::memset(dst, 0, cols);
+    FindHorizontalLines(src, row, cols, dst);
+    FindVerticalLines(src, row, cols, mask);
+  }
+}
+
+void LineFeatureFinder::FindHorizontalLines(const uint8_t *src, int row,
+                                            int cols, uint8_t *dst) {
+  const uint8_t *end = src + cols;
+  const uint8_t *it = src;
+  while (it < end) {
+    // Skip to the start of the next run
+    it = static_cast<const uint8_t *>(std::memchr(it, kLineValue, end - it));
+    if (it == nullptr) {
+      return;
+    }
+
+    // Find the end of the run, a run reaching the end of the row is ignored
+    const uint8_t *run = it;
+    while (it < end && *it == kLineValue) {
+      ++it;
+    }
+    if (it == end) {
+      return;
+    }
+
+    // Mark the run including the terminating pixel
+    const int kLength = static_cast<int>(it - run);
+    if (kLength >= min_length_h_) {
+      const int kCol = static_cast<int>(run - src);
+      std::memset(dst + kCol, kLineValue, kLength + 1);
+      horizontal_lines_.push_back({row, kCol, kLength + 1});
+    }
+  }
+}
+
+void LineFeatureFinder::FindVerticalLines(const uint8_t *src, int row,
+                                          int cols, Mat2DView<uint8_t> mask) {
+  int *runs = column_runs_.data();
+  for (int col = 0; col < cols; col++) {
+    const bool kOnLine = src[col] == kLineValue;
+
+    // A run terminated by this row, mark it including the terminating pixel
+    if (!kOnLine && runs[col] >= min_length_v_) {
+      const int kRow = row - runs[col];
+      for (int y = kRow; y <= row; y++) {
+        mask.At(y, col) = kLineValue;
+      }
+      vertical_lines_.push_back({kRow, col, runs[col] + 1});
+    }
+    runs[col] = kOnLine ? runs[col] + 1 : 0;
+  }
+}
+
+}  // namespace mat
+}  // namespace video_detect
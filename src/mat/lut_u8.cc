@@ -0,0 +1,153 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#include "video-detect/mat/lut_u8.h"
+
+#include "video-detect/util/cpu_features.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define VIDEO_DETECT_LUT_U8_X86
+#include <immintrin.h>
+#endif
+
+namespace video_detect {
+namespace mat {
+
+namespace {
+
+typedef void (*LutU8Row)(const uint8_t *src, const LutU8 &lut, int cols,
+                         uint8_t *dst);
+
+void LutU8RowScalar(const uint8_t *src, const LutU8 &lut, int cols,
+                    uint8_t *dst) {
+  for (int col = 0; col < cols; col++) {
+    dst[col] = lut[src[col]];
+  }
+}
+
+#ifdef VIDEO_DETECT_LUT_U8_X86
+
+//
+// The table is split into 16 tables of 16 entries which a byte shuffle looks
+// up. For table k the values are XORed with 16k, which clears the high nibble
+// of exactly the values belonging to table k. A saturating add of 0x70 then
+// sets the most significant bit of all other values, for which the shuffle
+// gives zero, so the results of all tables can be ORed together.
+//
+
+__attribute__((target("ssse3"))) void LutU8RowSsse3(const uint8_t *src,
+                                                    const LutU8 &lut, int cols,
+                                                    uint8_t *dst) {
+  __m128i tables[16];
+  for (int k = 0; k < 16; k++) {
+    tables[k] =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(lut.data() + 16 * k));
+  }
+  const __m128i kOffset = _mm_set1_epi8(0x70);
+
+  int col = 0;
+  for (; col + 16 <= cols; col += 16) {
+    const __m128i kValues =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + col));
+    __m128i result = _mm_setzero_si128();
+    for (int k = 0; k < 16; k++) {
+      const __m128i kIndex = _mm_adds_epu8(
+          _mm_xor_si128(kValues, _mm_set1_epi8(static_cast<char>(16 * k))),
+          kOffset);
+      result = _mm_or_si128(result, _mm_shuffle_epi8(tables[k], kIndex));
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + col), result);
+  }
+  LutU8RowScalar(src + col, lut, cols - col, dst + col);
+}
+
+__attribute__((target("avx2"))) void LutU8RowAvx2(const uint8_t *src,
+                                                  const LutU8 &lut, int cols,
+                                                  uint8_t *dst) {
+  __m256i tables[16];
+  for (int k = 0; k < 16; k++) {
+    const __m128i kTable =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(lut.data() + 16 * k));
+    tables[k] = _mm256_broadcastsi128_si256(kTable);
+  }
+  const __m256i kOffset = _mm256_set1_epi8(0x70);
+
+  int col = 0;
+  for (; col + 32 <= cols; col += 32) {
+    const __m256i kValues =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + col));
+    __m256i result = _mm256_setzero_si256();
+    for (int k = 0; k < 16; k++) {
+      const __m256i kIndex = _mm256_adds_epu8(
+          _mm256_xor_si256(kValues,
+                           _mm256_set1_epi8(static_cast<char>(16 * k))),
+          kOffset);
+      result = _mm256_or_si256(result, _mm256_shuffle_epi8(tables[k], kIndex));
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + col), result);
+  }
+  LutU8RowScalar(src + col, lut, cols - col, dst + col);
+}
+
+#endif  // VIDEO_DETECT_LUT_U8_X86
+
+LutU8Row GetLutU8Row(LutPath path) {
+#ifdef VIDEO_DETECT_LUT_U8_X86
+  switch (path) {
+    case LutPath::kAvx2:
+      return LutU8RowAvx2;
+    case LutPath::kSsse3:
+      return LutU8RowSsse3;
+    default:
+      break;
+  }
+#endif
+  return LutU8RowScalar;
+}
+
+LutPath SelectLutPath() {
+  // The 16 shuffles per vector only pay off with 32 byte vectors, a scalar
+  // table lookup is faster than the 16 byte path
+  if (IsLutPathSupported(LutPath::kAvx2)) {
+    return LutPath::kAvx2;
+  }
+  return LutPath::kScalar;
+}
+
+}  // namespace
+
+bool IsLutPathSupported(LutPath path) {
+#ifdef VIDEO_DETECT_LUT_U8_X86
+  switch (path) {
+    case LutPath::kAvx2:
+      return util::GetCpuFeatures().avx2;
+    case LutPath::kSsse3:
+      return util::GetCpuFeatures().ssse3;
+    default:
+      break;
+  }
+#endif
+  return path == LutPath::kScalar;
+}
+
+LutPath GetDefaultLutPath() {
+  static const LutPath kPath = SelectLutPath();
+  return kPath;
+}
+
+void ApplyLutU8(Mat2DView<const uint8_t> mat, const LutU8 &lut,
+                Mat2DView<uint8_t> result) {
+  ApplyLutU8(mat, lut, result, GetDefaultLutPath());
+}
+
+void ApplyLutU8(Mat2DView<const uint8_t> mat, const LutU8 &lut,
+                Mat2DView<uint8_t> result, LutPath path) {
+  const LutU8Row kLutRow = GetLutU8Row(path);
+  for (int row = 0; row < mat.GetRowCount(); row++) {
+    kLutRow(mat.GetRowPtr(row), lut, mat.GetColCount(), result.GetRowPtr(row));
+  }
+}
+
+}  // namespace mat
+}  // namespace video_detect
@@ -0,0 +1,194 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#include "video-detect/mat/projection.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <mutex>
+
+#include "video-detect/util/cpu_features.h"
+#include "video-detect/util/thread_pool.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define VIDEO_DETECT_PROJECTION_X86
+#include <immintrin.h>
+#endif
+
+namespace video_detect {
+namespace mat {
+
+namespace {
+
+// The column sums are accumulated in uint16 for at most this amount of rows,
+// 257 * 255 is the largest sum that still fits
+constexpr int kChunkRows = 257;
+
+typedef uint32_t (*ProjectRow)(const uint8_t *above, const uint8_t *src,
+                               int cols, uint16_t *acc);
+
+/**
+ * Add the horizontal gradients of a row to the uint16 column sums from the
+ * second column on, and return the sum of its vertical gradients
+ */
+uint32_t ProjectRowScalar(const uint8_t *above, const uint8_t *src, int cols,
+                          uint16_t *acc) {
+  uint32_t sum = 0;
+  for (int col = 0; col < cols; col++) {
+    sum += std::abs(src[col] - above[col]);
+  }
+  for (int col = 1; col < cols; col++) {
+    const int kDiff = std::abs(src[col] - src[col - 1]);
+    acc[col] = static_cast<uint16_t>(acc[col] + kDiff);
+  }
+  return sum;
+}
+
+#ifdef VIDEO_DETECT_PROJECTION_X86
+
+__attribute__((target("avx2"))) uint32_t ProjectRowAvx2(const uint8_t *above,
+                                                        const uint8_t *src,
+                                                        int cols,
+                                                        uint16_t *acc) {
+  const __m256i kZero = _mm256_setzero_si256();
+
+  // Thirty-two values at a time, the sum of absolute differences adds eight
+  // vertical gradients into each of the four 64 bit lanes
+  __m256i sum = kZero;
+  int col = 0;
+  for (; col + 32 <= cols; col += 32) {
+    const __m256i kValues =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + col));
+    const __m256i kAbove =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(above + col));
+    sum = _mm256_add_epi64(sum, _mm256_sad_epu8(kValues, kAbove));
+  }
+  __m128i lanes = _mm_add_epi64(_mm256_castsi256_si128(sum),
+                                _mm256_extracti128_si256(sum, 1));
+  lanes = _mm_add_epi64(lanes, _mm_unpackhi_epi64(lanes, lanes));
+  uint32_t total = static_cast<uint32_t>(_mm_cvtsi128_si32(lanes));
+  for (; col < cols; col++) {
+    total += std::abs(src[col] - above[col]);
+  }
+
+  // The horizontal gradients from the second column on, the absolute
+  // difference of unsigned values is the larger of the saturated differences
+  col = 1;
+  for (; col + 32 <= cols; col += 32) {
+    const __m256i kValues =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + col));
+    const __m256i kLeft =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + col - 1));
+    const __m256i kDiff = _mm256_or_si256(_mm256_subs_epu8(kValues, kLeft),
+                                          _mm256_subs_epu8(kLeft, kValues));
+
+    __m256i *dst = reinterpret_cast<__m256i *>(acc + col);
+    const __m256i kLow = _mm256_cvtepu8_epi16(_mm256_castsi256_si128(kDiff));
+    const __m256i kHigh =
+        _mm256_cvtepu8_epi16(_mm256_extracti128_si256(kDiff, 1));
+    _mm256_storeu_si256(dst, _mm256_add_epi16(_mm256_loadu_si256(dst), kLow));
+    _mm256_storeu_si256(dst + 1,
+                        _mm256_add_epi16(_mm256_loadu_si256(dst + 1), kHigh));
+  }
+  for (; col < cols; col++) {
+    const int kDiff = std::abs(src[col] - src[col - 1]);
+    acc[col] = static_cast<uint16_t>(acc[col] + kDiff);
+  }
+  return total;
+}
+
+#endif  // VIDEO_DETECT_PROJECTION_X86
+
+ProjectRow GetProjectRow(ProjectionPath path) {
+#ifdef VIDEO_DETECT_PROJECTION_X86
+  if (path == ProjectionPath::kAvx2) {
+    return ProjectRowAvx2;
+  }
+#endif
+  return ProjectRowScalar;
+}
+
+ProjectionPath SelectProjectionPath() {
+  if (IsProjectionPathSupported(ProjectionPath::kAvx2)) {
+    return ProjectionPath::kAvx2;
+  }
+  return ProjectionPath::kScalar;
+}
+
+}  // namespace
+
+bool IsProjectionPathSupported(ProjectionPath path) {
+#ifdef VIDEO_DETECT_PROJECTION_X86
+  if (path == ProjectionPath::kAvx2) {
+    return util::GetCpuFeatures().avx2;
+  }
+#endif
+  return path == ProjectionPath::kScalar;
+}
+
+ProjectionPath GetDefaultProjectionPath() {
+  static const ProjectionPath kPath = SelectProjectionPath();
+  return kPath;
+}
+
+void ProjectGradients(Mat2DView<const uint8_t> mat,
+                      std::vector<uint32_t> *row_profile,
+                      std::vector<uint32_t> *col_profile) {
+  const int rows = mat.GetRowCount();
+  const int cols = mat.GetColCount();
+  row_profile->assign(std::max(rows, 0), 0);
+  col_profile->assign(std::max(cols, 0), 0);
+  if (rows <= 0 || cols <= 0) {
+    return;
+  }
+
+  // Every band writes its own row sums and adds its column sums to the
+  // profile once it is done
+  const ProjectionPath kPath = GetDefaultProjectionPath();
+  std::mutex merge_access;
+  util::ParallelForRows(rows, cols, [&](int row_begin, int row_end) {
+    static thread_local std::vector<uint32_t> buffer;
+    buffer.assign(std::max<std::size_t>(buffer.size(), cols), 0);
+    ProjectGradientRows(mat, row_begin, row_end,
+                        row_profile->data() + row_begin, buffer.data(), kPath);
+
+    std::lock_guard<std::mutex> lock_guard(merge_access);
+    for (int col = 0; col < cols; col++) {
+      (*col_profile)[col] += buffer[col];
+    }
+  });
+}
+
+void ProjectGradientRows(Mat2DView<const uint8_t> mat, int row_begin,
+                         int row_end, uint32_t *row_profile,
+                         uint32_t *col_profile, ProjectionPath path) {
+  const int cols = mat.GetColCount();
+  if (row_begin >= row_end || cols <= 0) {
+    return;
+  }
+
+  // The uint16 column sums of a chunk of rows, the buffer is kept per thread
+  // and only grows
+  static thread_local std::vector<uint16_t> buffer;
+  buffer.resize(std::max<std::size_t>(buffer.size(), cols));
+  uint16_t *acc = buffer.data();
+  const ProjectRow kProjectRow = GetProjectRow(path);
+
+  for (int chunk = row_begin; chunk < row_end; chunk += kChunkRows) {
+    std::fill(acc, acc + cols, 0);
+    const int kChunkEnd = std::min(chunk + kChunkRows, row_end);
+    for (int row = chunk; row < kChunkEnd; row++) {
+      // The first row is its own neighbour, which has no gradient
+      const uint8_t *src = mat.GetRowPtr(row);
+      const uint8_t *above = row > 0 ? mat.GetRowPtr(row - 1) : src;
+      row_profile[row - row_begin] = kProjectRow(above, src, cols, acc);
+    }
+    for (int col = 0; col < cols; col++) {
+      col_profile[col] += acc[col];
+    }
+  }
+}
+
+}  // namespace mat
+}  // namespace video_detect
@@ -17,8 +17,16 @@ MatBridge::MatBridge(
     : worker_(worker), receiver_(receiver) {}
 
 void MatBridge::Accept(const cv::Mat &cv_mat) {
-  // Convert the incoming cv_mat to a single channel matrix (grayscale)
-  cv::Mat img_gray = opencv2::GrayscaleAdapter(cv_mat);
+  // Convert the incoming cv_mat to a single channel matrix (grayscale), a
+  // grayscale cv_mat is shared if it owns its data and copied otherwise
+  cv::Mat img_gray;
+  if (cv_mat.channels() != 1) {
+    img_gray = opencv2::GrayscaleAdapter(cv_mat);
+  } else if (cv_mat.u != nullptr) {
+    img_gray = cv_mat;
+  } else {
+    img_gray = cv_mat.clone();
+  }
 
   // Perform the bridging work by the worker to not hold up the calling chain
   worker_.Accept([this, img_gray = std::move(img_gray)]() {
@@ -28,4 +36,9 @@ void MatBridge::Accept(const cv::Mat &cv_mat) {
   });
 }
 
+void MatBridge::Accept(mat::Mat2D<uint8_t> mat) {
+  // The matrix is moved into the job, which keeps its storage alive
+  worker_.Accept([this, mat = std::move(mat)]() { receiver_.Accept(mat); });
+}
+
 }  // namespace video_detect
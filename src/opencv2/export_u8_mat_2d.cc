@@ -14,14 +14,16 @@
 namespace video_detect {
 namespace opencv2 {
 
-int ExportU8Mat2D::counter_ = 0;
+std::atomic<int> ExportU8Mat2D::counter_{0};
 
 ExportU8Mat2D::ExportU8Mat2D(std::string name, std::string path)
     : name_(name), path_(path) {}
 
-void ExportU8Mat2D::Accept(const mat::Mat2D<uint8_t> &mat) {
-  // Create the cv::Mat matrix
-  cv::Mat cv_mat = ConvertMat2DToCvMat(mat);
+void ExportU8Mat2D::Accept(const mat::Mat2D<uint8_t> &mat) { Export(mat); }
+
+void ExportU8Mat2D::Export(mat::Mat2DView<const uint8_t> mat) {
+  // Create a cv::Mat header onto the matrix values
+  cv::Mat cv_mat = WrapMat2DInCvMat(mat);
 
   // Write the cv::Mat matrix
   const std::string output_file =
@@ -24,7 +24,58 @@ Options::Options()
           {{"--clevel"},
            {"[Optional] Set a confidence level (not percentage) for frame size "
             "detected(integer). The default is 10."}},
-      }, confidence_level_(10), frame_modulo_(20) {
+          {{"--threads"},
+           {"[Optional] Set the amount of threads used to analyze a frame "
+            "(integer). 1 analyzes on a single thread. The default is 0, "
+            "which uses one thread per hardware thread."}},
+          {{"--gridmax"},
+           {"[Optional] Set the maximum amount of frames along the height or "
+            "the width of the video (integer). The default is 16."}},
+          {{"--engine"},
+           {"[Optional] Set the frame size estimation engine, either "
+            "\'contour\' (contour and corner analysis), \'profile\' "
+            "(edge projection profiles) or \'hypothesis\' (edges along "
+            "candidate grids). The default is contour."}},
+          {{"--margin"},
+           {"[Optional] Set the factor by which the boundaries of a grid "
+            "must be stronger than the lines between them for the "
+            "hypothesis engine (decimal). The default is 2."}},
+          {{"--fskip"},
+           {"[Optional] Set the frames the decoder skips without decoding "
+            "them, either \'none\', \'nonref\' (frames no other frame is "
+            "predicted from) or \'nonkey\' (all but the keyframes). The "
+            "--fmod filter only counts the decoded frames. The default is "
+            "none."}},
+          {{"--sample-every"},
+           {"[Optional] Sample a frame every given amount of seconds "
+            "(decimal, e.g. 5 or 5s) by seeking through the video instead "
+            "of decoding every frame. Replaces the --fmod filter. The "
+            "default is 0, which decodes every frame."}},
+          {{"--samples"},
+           {"[Optional] Sample the given amount of frames spread evenly over "
+            "the video (integer) by seeking through the video instead of "
+            "decoding every frame. Replaces the --fmod filter. The default "
+            "is 0, which decodes every frame."}},
+          {{"--dthreads"},
+           {"[Optional] Set the amount of threads used to decode the video "
+            "(integer). The default is 0, which uses one thread per hardware "
+            "thread."}},
+          {{"--dthreading"},
+           {"[Optional] Set how the decoder uses its threads, either "
+            "\'frame\' (several frames at once), \'slice\' (the slices of a "
+            "frame at once) or \'auto\' (frames if the codec supports it, "
+            "else slices). The default is auto."}},
+          {{"--segments"},
+           {"[Optional] Split the video in the given amount of equally long "
+            "segments (integer), which are decoded and analyzed in parallel "
+            "and whose votes are merged. Cannot be combined with sampling. "
+            "The default is 1, which reads the video from start to end."}},
+      }, confidence_level_(10), frame_modulo_(20), thread_count_(0),
+      max_grid_size_(16), engine_(Engine::kContour), margin_(2.f),
+      frame_skip_(ffmpeg::FrameSkip::kNone), sample_interval_(0.),
+      sample_count_(0), decode_thread_count_(0),
+      decode_threading_(ffmpeg::DecodeThreading::kFrameAndSlice),
+      segment_count_(1) {
   // Register the option handlers
   option_handlers_.insert(std::make_pair(
       "--help", std::bind(&Options::HandleHelp, this, std::placeholders::_1)));
@@ -43,6 +94,36 @@ Options::Options()
   option_handlers_.insert(std::make_pair(
       "--clevel",
       std::bind(&Options::HandleConfidenceLevel, this, std::placeholders::_1)));
+  option_handlers_.insert(std::make_pair(
+      "--threads",
+      std::bind(&Options::HandleThreadCount, this, std::placeholders::_1)));
+  option_handlers_.insert(std::make_pair(
+      "--gridmax",
+      std::bind(&Options::HandleMaxGridSize, this, std::placeholders::_1)));
+  option_handlers_.insert(std::make_pair(
+      "--engine",
+      std::bind(&Options::HandleEngine, this, std::placeholders::_1)));
+  option_handlers_.insert(std::make_pair(
+      "--margin",
+      std::bind(&Options::HandleMargin, this, std::placeholders::_1)));
+  option_handlers_.insert(std::make_pair(
+      "--fskip",
+      std::bind(&Options::HandleFrameSkip, this, std::placeholders::_1)));
+  option_handlers_.insert(std::make_pair(
+      "--sample-every",
+      std::bind(&Options::HandleSampleInterval, this, std::placeholders::_1)));
+  option_handlers_.insert(std::make_pair(
+      "--samples",
+      std::bind(&Options::HandleSampleCount, this, std::placeholders::_1)));
+  option_handlers_.insert(std::make_pair(
+      "--dthreads", std::bind(&Options::HandleDecodeThreadCount, this,
+                              std::placeholders::_1)));
+  option_handlers_.insert(std::make_pair(
+      "--dthreading", std::bind(&Options::HandleDecodeThreading, this,
+                                std::placeholders::_1)));
+  option_handlers_.insert(std::make_pair(
+      "--segments",
+      std::bind(&Options::HandleSegmentCount, this, std::placeholders::_1)));
 }
 
 void Options::PrintHelp() {
@@ -103,7 +184,11 @@ bool Options::Parse(int argc, const char *argv[]) {
   }
 
   // Ensure we have sufficient information to continue with the program
-  if (file_input_.empty() || frame_modulo_ <= 0 || confidence_level_ <= 0) {
+  if (file_input_.empty() || frame_modulo_ <= 0 || confidence_level_ <= 0 ||
+      thread_count_ < 0 || max_grid_size_ <= 0 || margin_ <= 1.f ||
+      sample_interval_ < 0. || sample_count_ < 0 || decode_thread_count_ < 0 ||
+      (sample_interval_ > 0. && sample_count_ > 0) || segment_count_ <= 0 ||
+      (segment_count_ > 1 && IsSampling())) {
     std::cout << "Not all arguments have been provided. See \'video-detect "
                  "--help\' for more information"
               << std::endl;
@@ -143,6 +228,148 @@ void Options::HandleConfidenceLevel(const std::string &value) {
   }
 }
 
+void Options::HandleThreadCount(const std::string &value) {
+  try {
+    thread_count_ = std::stoi(value);
+  } catch (std::exception &e) {
+    std::cerr << "Invalid integer conversion: " << value
+              << ", error: " << e.what() << std::endl;
+  }
+  if (thread_count_ < 0) {
+    std::cout << "Invalid thread count: " << value << std::endl;
+    std::cout << "Choose an integer value of zero or larger" << std::endl;
+  }
+}
+
+void Options::HandleMaxGridSize(const std::string &value) {
+  try {
+    max_grid_size_ = std::stoi(value);
+  } catch (std::exception &e) {
+    std::cerr << "Invalid integer conversion: " << value
+              << ", error: " << e.what() << std::endl;
+  }
+  if (max_grid_size_ <= 0) {
+    std::cout << "Invalid maximum grid size: " << value << std::endl;
+    std::cout << "Choose an integer value larger than zero" << std::endl;
+  }
+}
+
+void Options::HandleEngine(const std::string &value) {
+  if (value == "contour") {
+    engine_ = Engine::kContour;
+  } else if (value == "profile") {
+    engine_ = Engine::kProfile;
+  } else if (value == "hypothesis") {
+    engine_ = Engine::kHypothesis;
+  } else {
+    std::cout << "Invalid engine: " << value << std::endl;
+    std::cout << "Choose either contour, profile or hypothesis" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+}
+
+void Options::HandleMargin(const std::string &value) {
+  try {
+    margin_ = std::stof(value);
+  } catch (std::exception &e) {
+    std::cerr << "Invalid decimal conversion: " << value
+              << ", error: " << e.what() << std::endl;
+  }
+  if (margin_ <= 1.f) {
+    std::cout << "Invalid margin: " << value << std::endl;
+    std::cout << "Choose a decimal value larger than one" << std::endl;
+  }
+}
+
+void Options::HandleFrameSkip(const std::string &value) {
+  if (value == "none") {
+    frame_skip_ = ffmpeg::FrameSkip::kNone;
+  } else if (value == "nonref") {
+    frame_skip_ = ffmpeg::FrameSkip::kNonReference;
+  } else if (value == "nonkey") {
+    frame_skip_ = ffmpeg::FrameSkip::kNonKey;
+  } else {
+    std::cout << "Invalid frame skip: " << value << std::endl;
+    std::cout << "Choose either none, nonref or nonkey" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+}
+
+void Options::HandleSampleInterval(const std::string &value) {
+  // The interval is in seconds, the only unit accepted after it is s
+  std::size_t pos = 0;
+  try {
+    sample_interval_ = std::stod(value, &pos);
+  } catch (std::exception &e) {
+    std::cerr << "Invalid decimal conversion: " << value
+              << ", error: " << e.what() << std::endl;
+    return;
+  }
+  const std::string kUnit = value.substr(pos);
+  if (!kUnit.empty() && kUnit != "s") {
+    std::cout << "Invalid sample interval unit: " << value << std::endl;
+    std::cout << "Choose a value in seconds, e.g. 5 or 5s" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  if (sample_interval_ < 0.) {
+    std::cout << "Invalid sample interval: " << value << std::endl;
+    std::cout << "Choose a decimal value of zero or larger" << std::endl;
+  }
+}
+
+void Options::HandleSampleCount(const std::string &value) {
+  try {
+    sample_count_ = std::stoi(value);
+  } catch (std::exception &e) {
+    std::cerr << "Invalid integer conversion: " << value
+              << ", error: " << e.what() << std::endl;
+  }
+  if (sample_count_ < 0) {
+    std::cout << "Invalid sample count: " << value << std::endl;
+    std::cout << "Choose an integer value of zero or larger" << std::endl;
+  }
+}
+
+void Options::HandleDecodeThreadCount(const std::string &value) {
+  try {
+    decode_thread_count_ = std::stoi(value);
+  } catch (std::exception &e) {
+    std::cerr << "Invalid integer conversion: " << value
+              << ", error: " << e.what() << std::endl;
+  }
+  if (decode_thread_count_ < 0) {
+    std::cout << "Invalid decode thread count: " << value << std::endl;
+    std::cout << "Choose an integer value of zero or larger" << std::endl;
+  }
+}
+
+void Options::HandleDecodeThreading(const std::string &value) {
+  if (value == "auto") {
+    decode_threading_ = ffmpeg::DecodeThreading::kFrameAndSlice;
+  } else if (value == "frame") {
+    decode_threading_ = ffmpeg::DecodeThreading::kFrame;
+  } else if (value == "slice") {
+    decode_threading_ = ffmpeg::DecodeThreading::kSlice;
+  } else {
+    std::cout << "Invalid decode threading: " << value << std::endl;
+    std::cout << "Choose either auto, frame or slice" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+}
+
+void Options::HandleSegmentCount(const std::string &value) {
+  try {
+    segment_count_ = std::stoi(value);
+  } catch (std::exception &e) {
+    std::cerr << "Invalid integer conversion: " << value
+              << ", error: " << e.what() << std::endl;
+  }
+  if (segment_count_ <= 0) {
+    std::cout << "Invalid segment count: " << value << std::endl;
+    std::cout << "Choose an integer value larger than zero" << std::endl;
+  }
+}
+
 void Options::HandleHelp(const std::string &value) {
   // Print the help section and exit
   PrintHelp();
@@ -160,5 +387,22 @@ const std::string &Options::GetOutputPath() const { return output_path_; }
 bool Options::IsExportImages() const { return !output_path_.empty(); }
 const int Options::GetFrameModulo() const { return frame_modulo_; }
 const int Options::GetConfidenceLevel() const { return confidence_level_; }
+const int Options::GetThreadCount() const { return thread_count_; }
+const int Options::GetMaxGridSize() const { return max_grid_size_; }
+Options::Engine Options::GetEngine() const { return engine_; }
+float Options::GetMargin() const { return margin_; }
+ffmpeg::FrameSkip Options::GetFrameSkip() const { return frame_skip_; }
+double Options::GetSampleInterval() const { return sample_interval_; }
+const int Options::GetSampleCount() const { return sample_count_; }
+bool Options::IsSampling() const {
+  return sample_interval_ > 0. || sample_count_ > 0;
+}
+const int Options::GetDecodeThreadCount() const {
+  return decode_thread_count_;
+}
+ffmpeg::DecodeThreading Options::GetDecodeThreading() const {
+  return decode_threading_;
+}
+const int Options::GetSegmentCount() const { return segment_count_; }
 
 }  // namespace video_detect
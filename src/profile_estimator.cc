@@ -0,0 +1,86 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#include "video-detect/profile_estimator.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "video-detect/mat/projection.h"
+
+namespace video_detect {
+
+constexpr float ProfileEstimator::kMinPeakRatio;
+constexpr float ProfileEstimator::kMinPeakFraction;
+
+namespace {
+
+/**
+ * Check whether the profile peaks at every boundary of an amount of equal
+ * frames
+ */
+bool IsGridCount(const std::vector<uint32_t> &profile, uint32_t min_peak,
+                 int count) {
+  const int kSize = static_cast<int>(profile.size());
+
+  // A boundary may be a pixel or two off and have an edge on either side
+  const int kTolerance = std::max(2, kSize / 128);
+
+  for (int k = 1; k < count; k++) {
+    const int kCenter = (k * kSize + count / 2) / count;
+    const auto kBegin = profile.begin() + std::max(kCenter - kTolerance, 0);
+    const auto kEnd =
+        profile.begin() + std::min(kCenter + kTolerance + 1, kSize);
+    if (*std::max_element(kBegin, kEnd) < min_peak) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+ProfileEstimator::ProfileEstimator(bool print_votes, int confidence_level,
+                                   int max_grid_size)
+    : GridEstimator(print_votes, confidence_level, max_grid_size) {}
+
+void ProfileEstimator::Accept(const mat::Mat2D<uint8_t> &mat) {
+  // 1. Sum the gradients of every row and every column in a single pass
+  mat::ProjectGradients(mat, &row_profile_, &col_profile_);
+
+  // 2. Vote for the grid whose boundaries are all peaks of the profiles
+  //    and update the best estimate frame size
+  const int kRowCount = FindGridCount(row_profile_, GetMaxGridSize());
+  const int kColCount = FindGridCount(col_profile_, GetMaxGridSize());
+  Vote(mat, kRowCount, kColCount);
+}
+
+int ProfileEstimator::FindGridCount(const std::vector<uint32_t> &profile,
+                                    int max_grid_size) {
+  uint64_t total = 0;
+  uint32_t max = 0;
+  for (uint32_t value : profile) {
+    total += value;
+    max = std::max(max, value);
+  }
+  if (total == 0) {
+    return 1;
+  }
+  const float kMean = (1.f * total) / (1.f * profile.size());
+  const uint32_t kMinPeak = static_cast<uint32_t>(
+      std::ceil(std::max(kMinPeakRatio * kMean, kMinPeakFraction * max)));
+
+  // The boundaries of a grid include those of its divisors, so the largest
+  // amount whose boundaries all peak is the grid
+  const int kMaxCount =
+      std::min(max_grid_size, static_cast<int>(profile.size()) / 8);
+  for (int count = kMaxCount; count > 1; count--) {
+    if (IsGridCount(profile, kMinPeak, count)) {
+      return count;
+    }
+  }
+  return 1;
+}
+
+}  // namespace video_detect
@@ -0,0 +1,32 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#include "video-detect/util/cpu_features.h"
+
+namespace video_detect {
+namespace util {
+
+namespace {
+
+CpuFeatures DetectCpuFeatures() {
+  CpuFeatures features;
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  // Query CPUID
+  __builtin_cpu_init();
+  features.sse41 = __builtin_cpu_supports("sse4.1");
+  features.ssse3 = __builtin_cpu_supports("ssse3");
+  features.avx2 = __builtin_cpu_supports("avx2");
+#endif
+  return features;
+}
+
+}  // namespace
+
+const CpuFeatures &GetCpuFeatures() {
+  static const CpuFeatures kFeatures = DetectCpuFeatures();
+  return kFeatures;
+}
+
+}  // namespace util
+}  // namespace video_detect
@@ -0,0 +1,151 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#include "video-detect/util/thread_pool.h"
+
+#include <algorithm>
+#include <memory>
+
+namespace video_detect {
+namespace util {
+
+namespace {
+
+// Set on the pool threads and while the calling thread runs bands, nested
+// loops then run serially instead of waiting on the busy pool
+thread_local bool in_parallel_for = false;
+
+// The amount of bytes of the rows in a band, about half a typical L2 cache
+constexpr std::size_t kBandBytes = 128 * 1024;
+
+std::mutex pool_access;
+std::unique_ptr<ThreadPool> pool;
+
+}  // namespace
+
+ThreadPool::ThreadPool(int thread_count) {
+  for (int i = 1; i < thread_count; i++) {
+    threads_.emplace_back([this] { DoWork(); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock_guard(state_access_);
+    stop_ = true;
+  }
+  work_available_.notify_all();
+  for (auto &thread : threads_) {
+    thread.join();
+  }
+}
+
+void ThreadPool::ParallelFor(int begin, int end, int grain,
+                             const std::function<void(int, int)> &body) {
+  grain = std::max(grain, 1);
+  if (begin >= end) {
+    return;
+  }
+
+  // Run serially when there is nothing to share or the pool is in use
+  std::unique_lock<std::mutex> run_lock(run_access_, std::defer_lock);
+  if (threads_.empty() || end - begin <= grain || in_parallel_for ||
+      !run_lock.try_lock()) {
+    body(begin, end);
+    return;
+  }
+
+  // Publish the loop and wake up the threads
+  {
+    std::lock_guard<std::mutex> lock_guard(state_access_);
+    body_ = &body;
+    next_ = begin;
+    end_ = end;
+    grain_ = grain;
+    pending_ = static_cast<int>(threads_.size());
+    ++generation_;
+  }
+  work_available_.notify_all();
+
+  // Take part in the loop, then wait for the other threads to finish
+  in_parallel_for = true;
+  RunBands();
+  in_parallel_for = false;
+
+  std::unique_lock<std::mutex> lock(state_access_);
+  work_done_.wait(lock, [this] { return pending_ == 0; });
+  body_ = nullptr;
+}
+
+void ThreadPool::DoWork() {
+  in_parallel_for = true;
+  unsigned long generation = 0;  // NOLINT(runtime/int)
+  std::unique_lock<std::mutex> lock(state_access_);
+  while (true) {
+    work_available_.wait(
+        lock, [&] { return stop_ || generation_ != generation; });
+    if (stop_) {
+      return;
+    }
+    generation = generation_;
+
+    lock.unlock();
+    RunBands();
+    lock.lock();
+
+    if (--pending_ == 0) {
+      work_done_.notify_one();
+    }
+  }
+}
+
+void ThreadPool::RunBands() {
+  while (true) {
+    const int kBegin = next_.fetch_add(grain_);
+    if (kBegin >= end_) {
+      return;
+    }
+    (*body_)(kBegin, std::min(kBegin + grain_, end_));
+  }
+}
+
+void SetThreadCount(int thread_count) {
+  if (thread_count <= 0) {
+    thread_count = static_cast<int>(std::thread::hardware_concurrency());
+  }
+  std::lock_guard<std::mutex> lock_guard(pool_access);
+  pool = std::make_unique<ThreadPool>(thread_count);
+}
+
+int GetThreadCount() {
+  std::lock_guard<std::mutex> lock_guard(pool_access);
+  return pool != nullptr ? pool->GetThreadCount() : 1;
+}
+
+void ParallelFor(int begin, int end, int grain,
+                 const std::function<void(int, int)> &body) {
+  ThreadPool *thread_pool = nullptr;
+  {
+    std::lock_guard<std::mutex> lock_guard(pool_access);
+    thread_pool = pool.get();
+  }
+  if (thread_pool == nullptr) {
+    body(begin, end);
+    return;
+  }
+  thread_pool->ParallelFor(begin, end, grain, body);
+}
+
+void ParallelForRows(int rows, std::size_t row_bytes,
+                     const std::function<void(int, int)> &body) {
+  const int kThreads = GetThreadCount();
+  const std::size_t kRowBytes = std::max<std::size_t>(row_bytes, 1);
+  const int kCacheRows =
+      static_cast<int>(std::max<std::size_t>(kBandBytes / kRowBytes, 1));
+  const int kThreadRows = (rows + kThreads - 1) / kThreads;
+  ParallelFor(0, rows, std::min(kCacheRows, kThreadRows), body);
+}
+
+}  // namespace util
+}  // namespace video_detect
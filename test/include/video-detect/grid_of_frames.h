@@ -0,0 +1,63 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#ifndef VIDEO_DETECT_TEST_INCLUDE_VIDEO_DETECT_GRID_OF_FRAMES_H_
+#define VIDEO_DETECT_TEST_INCLUDE_VIDEO_DETECT_GRID_OF_FRAMES_H_
+
+#include <cstdint>
+#include <cstdlib>
+
+#include "video-detect/mat/mat_2d.h"
+
+namespace video_detect {
+
+/**
+ * @brief Create a grid of frames with dark borders and a brighter blob at a
+ * random place in every frame as its content
+ *
+ * @param rows       the amount of rows of frames
+ * @param cols       the amount of columns of frames
+ * @param frame_rows the height of a frame
+ * @param frame_cols the width of a frame
+ */
+inline mat::Mat2D<uint8_t> MakeGridOfFrames(int rows, int cols, int frame_rows,
+                                            int frame_cols) {
+  mat::Mat2D<uint8_t> mat(rows * frame_rows, cols * frame_cols);
+  for (int row = 0; row < mat.GetRowCount(); row++) {
+    for (int col = 0; col < mat.GetColCount(); col++) {
+      const bool kBorder = row % frame_rows < 3 || col % frame_cols < 3;
+      mat.SetValue(row, col, kBorder ? 0 : 200);
+    }
+  }
+
+  // Add a brighter blob at a random place in every frame as its content
+  std::srand(5);
+  for (int frame_row = 0; frame_row < mat.GetRowCount();
+       frame_row += frame_rows) {
+    for (int frame_col = 0; frame_col < mat.GetColCount();
+         frame_col += frame_cols) {
+      const int kRow =
+          frame_row + frame_rows / 12 + std::rand() % (frame_rows / 2);
+      const int kCol =
+          frame_col + frame_cols / 16 + std::rand() % (frame_cols * 9 / 16);
+      for (int row = kRow; row < kRow + frame_rows / 3; row++) {
+        for (int col = kCol; col < kCol + frame_cols * 5 / 16; col++) {
+          mat.SetValue(row, col, 250);
+        }
+      }
+    }
+  }
+  return mat;
+}
+
+/**
+ * @brief Create a grid of 3 x 4 frames of 120 x 160 pixels
+ */
+inline mat::Mat2D<uint8_t> MakeGridOfFrames() {
+  return MakeGridOfFrames(3, 4, 120, 160);
+}
+
+}  // namespace video_detect
+
+#endif  // VIDEO_DETECT_TEST_INCLUDE_VIDEO_DETECT_GRID_OF_FRAMES_H_
@@ -0,0 +1,113 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#include "video-detect/divisor_votes.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace video_detect {
+
+TEST(DivisorVotesTests, TestVotesMatchFloatDivision) {
+  DivisorVotes votes(16);
+  votes.SetSize(600);
+
+  // Position 200 divides 600 in 3 tiles, 190 in 3.1 tiles which is no vote
+  votes.Vote(200);
+  votes.Vote(190);
+  EXPECT_EQ(votes.GetVotes(3), 1);
+  EXPECT_EQ(votes.GetCandidates(), std::vector<int>({3}));
+
+  // Further votes add the amount of tiles
+  votes.Vote(200);
+  votes.Vote(199);
+  EXPECT_EQ(votes.GetVotes(3), 7);
+
+  // The edges of the frame do not vote
+  votes.Vote(0);
+  votes.Vote(1);
+  EXPECT_EQ(votes.GetCandidates(), std::vector<int>({3}));
+}
+
+TEST(DivisorVotesTests, TestBestDivisorDividesOtherCandidates) {
+  DivisorVotes votes(16);
+  EXPECT_EQ(votes.GetBestDivisor(), 0);
+
+  // Corners of a 6 tile wide window and an outlier
+  votes.SetSize(600);
+  for (int i = 0; i < 5; i++) {
+    votes.Vote(100);
+    votes.Vote(200);
+    votes.Vote(300);
+  }
+  votes.Vote(66);
+  EXPECT_EQ(votes.GetCandidates(), std::vector<int>({2, 3, 6, 9}));
+  EXPECT_EQ(votes.GetModuloSum(6), 6);
+  EXPECT_EQ(votes.GetBestDivisor(), 6);
+
+  // Votes are kept when the size changes
+  votes.SetSize(300);
+  EXPECT_EQ(votes.GetVotes(6), 25);
+  votes.Vote(50);
+  EXPECT_EQ(votes.GetVotes(6), 31);
+}
+
+TEST(DivisorVotesTests, TestMergeEqualsVotingEverything) {
+  const std::vector<int> kPositions = {100, 200, 300, 66, 200, 150, 100, 120};
+
+  // Vote all positions in one object
+  DivisorVotes all(16);
+  all.SetSize(600);
+  for (int position : kPositions) {
+    all.Vote(position);
+  }
+
+  // Vote them split over three objects, one of them never sized
+  DivisorVotes first(16);
+  DivisorVotes second(16);
+  DivisorVotes third(16);
+  first.SetSize(600);
+  second.SetSize(600);
+  for (std::size_t i = 0; i < kPositions.size(); i++) {
+    (i < 3 ? first : second).Vote(kPositions[i]);
+  }
+
+  // Merge in a different order, (third + second) + first
+  third.Merge(second);
+  third.Merge(first);
+  EXPECT_EQ(third.GetSize(), 600);
+  EXPECT_EQ(third.GetCandidates(), all.GetCandidates());
+  for (int divisor = 1; divisor <= 16; divisor++) {
+    EXPECT_EQ(third.GetVotes(divisor), all.GetVotes(divisor));
+    EXPECT_EQ(third.GetModuloSum(divisor), all.GetModuloSum(divisor));
+  }
+  EXPECT_EQ(third.GetBestDivisor(), all.GetBestDivisor());
+}
+
+TEST(DivisorVotesTests, TestModuloSumsOnlyOverBoundedCandidates) {
+  DivisorVotes votes(8);
+  votes.SetSize(720);
+
+  // Amounts above the maximum are no candidates
+  votes.Vote(40);
+  EXPECT_EQ(votes.GetVotes(18), 0);
+  EXPECT_TRUE(votes.GetCandidates().empty());
+
+  // Vote for every position and compare the sums to a recount
+  for (int position = 0; position < 720; position++) {
+    votes.Vote(position);
+  }
+  const std::vector<int> kCandidates = votes.GetCandidates();
+  EXPECT_EQ(kCandidates.back(), 8);
+  for (int divisor = 1; divisor <= 8; divisor++) {
+    int sum = 0;
+    for (int other : kCandidates) {
+      sum += divisor % other;
+    }
+    EXPECT_EQ(votes.GetModuloSum(divisor), sum);
+  }
+}
+
+}  // namespace video_detect
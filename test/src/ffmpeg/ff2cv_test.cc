@@ -0,0 +1,39 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#include "video-detect/ffmpeg/ff2cv.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace video_detect {
+namespace ffmpeg {
+
+TEST(FfmpegTests, TestSampleTimestampsOfCount) {
+  // 4 samples of a 10 second video starting at 1 second, in milliseconds
+  const std::vector<int64_t> kTimestamps =
+      GetSampleTimestamps(1000, 10000, .001, 0., 4);
+
+  // Each sample is in the middle of a quarter of the video
+  EXPECT_EQ(kTimestamps, std::vector<int64_t>({2250, 4750, 7250, 9750}));
+}
+
+TEST(FfmpegTests, TestSampleTimestampsOfInterval) {
+  // Every 2.5 seconds of a 10 second video in a 1/1024 second time base
+  const std::vector<int64_t> kTimestamps =
+      GetSampleTimestamps(0, 10240, 1. / 1024., 2.5, 0);
+
+  // The samples start at the first frame and stay within the video
+  EXPECT_EQ(kTimestamps, std::vector<int64_t>({0, 2560, 5120, 7680}));
+}
+
+TEST(FfmpegTests, TestSampleTimestampsOfUnknownLength) {
+  EXPECT_TRUE(GetSampleTimestamps(0, 0, .001, 5., 0).empty());
+  EXPECT_TRUE(GetSampleTimestamps(0, 0, .001, 0., 8).empty());
+}
+
+}  // namespace ffmpeg
+}  // namespace video_detect
@@ -0,0 +1,107 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#include "video-detect/ffmpeg/luma_converter.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+// FFmpeg
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <libavutil/frame.h>
+#include <libavutil/pixfmt.h>
+
+#ifdef __cplusplus
+}
+#endif
+
+#include "video-detect/mat/mat_2d.h"
+
+namespace video_detect {
+namespace ffmpeg {
+
+namespace {
+
+constexpr int kWidth = 256;
+constexpr int kHeight = 4;
+
+// Create a frame of a horizontal gray ramp from 0 to 255, in the range given
+AVFrame *MakeGrayRamp(AVPixelFormat format, AVColorRange range) {
+  AVFrame *frame = av_frame_alloc();
+  frame->format = format;
+  frame->width = kWidth;
+  frame->height = kHeight;
+  frame->color_range = range;
+  if (av_frame_get_buffer(frame, 0) < 0) {
+    av_frame_free(&frame);
+    return nullptr;
+  }
+
+  for (int row = 0; row < kHeight; row++) {
+    uint8_t *dst = frame->data[0] + row * frame->linesize[0];
+    for (int col = 0; col < kWidth; col++) {
+      if (format == AV_PIX_FMT_RGB24) {
+        std::memset(dst + 3 * col, col, 3);
+      } else if (range == AVCOL_RANGE_MPEG) {
+        dst[col] = static_cast<uint8_t>(16 + (col * 219 + 255 / 2) / 255);
+      } else {
+        dst[col] = static_cast<uint8_t>(col);
+      }
+    }
+  }
+
+  // A gray picture has neutral chroma
+  if (format != AV_PIX_FMT_RGB24) {
+    for (int plane = 1; plane < 3; plane++) {
+      std::memset(frame->data[plane], 128,
+                  frame->linesize[plane] * (kHeight / 2));
+    }
+  }
+  return frame;
+}
+
+}  // namespace
+
+TEST(FfmpegTests, TestLumaConverterPathsGiveFullRange) {
+  LumaConverter converter;
+  AVFrame *full = MakeGrayRamp(AV_PIX_FMT_YUV420P, AVCOL_RANGE_JPEG);
+  AVFrame *limited = MakeGrayRamp(AV_PIX_FMT_YUV420P, AVCOL_RANGE_MPEG);
+  AVFrame *rgb = MakeGrayRamp(AV_PIX_FMT_RGB24, AVCOL_RANGE_UNSPECIFIED);
+  ASSERT_NE(full, nullptr);
+  ASSERT_NE(limited, nullptr);
+  ASSERT_NE(rgb, nullptr);
+
+  // The full range luma plane is wrapped, the limited range one expanded and
+  // the RGB frame converted with swscale
+  const mat::Mat2D<uint8_t> kFull = converter.Convert(full);
+  const mat::Mat2D<uint8_t> kLimited = converter.Convert(limited);
+  const mat::Mat2D<uint8_t> kRgb = converter.Convert(rgb);
+  EXPECT_EQ(kFull.GetRowPtr(0), full->data[0]);
+  ASSERT_EQ(kLimited.GetColCount(), kWidth);
+  ASSERT_EQ(kRgb.GetColCount(), kWidth);
+
+  // All of them give the same full range values, apart from rounding
+  for (int row = 0; row < kHeight; row++) {
+    for (int col = 0; col < kWidth; col++) {
+      EXPECT_EQ(kFull.GetValue(row, col), col);
+      EXPECT_NEAR(kLimited.GetValue(row, col), col, 1);
+      EXPECT_NEAR(kRgb.GetValue(row, col), col, 2);
+    }
+  }
+
+  // The frame buffer of the decoder is not written
+  EXPECT_EQ(limited->data[0][0], 16);
+  EXPECT_EQ(limited->data[0][kWidth - 1], 235);
+
+  av_frame_free(&rgb);
+  av_frame_free(&limited);
+  av_frame_free(&full);
+}
+
+}  // namespace ffmpeg
+}  // namespace video_detect
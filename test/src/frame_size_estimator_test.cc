@@ -0,0 +1,37 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#include "video-detect/frame_size_estimator.h"
+
+#include <gtest/gtest.h>
+
+#include "video-detect/mat/mat_2d.h"
+
+namespace video_detect {
+
+TEST(FrameSizeEstimatorTests, TestNoScratchAllocationAfterFirstFrame) {
+  // Create a 2x2 grid of bright frames with dark borders
+  mat::Mat2D<uint8_t> mat(120, 160);
+  for (int row = 0; row < mat.GetRowCount(); row++) {
+    for (int col = 0; col < mat.GetColCount(); col++) {
+      const bool kBorder = row % 60 < 4 || col % 80 < 4;
+      mat.SetValue(row, col, kBorder ? 0 : 150);
+    }
+  }
+
+  FrameSizeEstimator estimator(false, "", 5, 16);
+
+  // The first frame fills the scratch pool
+  estimator.Accept(mat);
+  const std::size_t kAllocations = estimator.GetScratchAllocationCount();
+  EXPECT_GT(kAllocations, 0u);
+
+  // Subsequent frames of the same size reuse the pooled buffers
+  for (int i = 0; i < 3; i++) {
+    estimator.Accept(mat);
+  }
+  EXPECT_EQ(estimator.GetScratchAllocationCount(), kAllocations);
+}
+
+}  // namespace video_detect
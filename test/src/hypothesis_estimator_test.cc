@@ -0,0 +1,61 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#include "video-detect/hypothesis_estimator.h"
+
+#include <gtest/gtest.h>
+
+#include "video-detect/grid_of_frames.h"
+#include "video-detect/mat/mat_2d.h"
+
+namespace video_detect {
+
+TEST(HypothesisEstimatorTests, TestEstimateGridOfFrames) {
+  const mat::Mat2D<uint8_t> mat = MakeGridOfFrames();
+
+  HypothesisEstimator estimator(false, 3, 16, 2.f);
+  for (int i = 0; i < 3; i++) {
+    estimator.Accept(mat);
+  }
+  EXPECT_TRUE(estimator.HasBestEstimate());
+  EXPECT_EQ(estimator.GetBestEstimateFrameSize(), std::make_pair(160, 120));
+
+  // Once voted for, only the grid and its multiples are checked and only a
+  // fraction of the pixels is read
+  EXPECT_LT(estimator.GetLastReadCount(), 360u * 640u / 4u);
+}
+
+TEST(HypothesisEstimatorTests, TestEarlyDivisorVoteDoesNotLockTheGrid) {
+  // The control lines of a divisor of a grid fall on no boundary, so the 2 x 2
+  // grid voted for by the first image also wins on the 6 x 6 grid
+  const mat::Mat2D<uint8_t> kCoarse = MakeGridOfFrames(2, 2, 180, 324);
+  const mat::Mat2D<uint8_t> kFine = MakeGridOfFrames(6, 6, 60, 108);
+
+  HypothesisEstimator estimator(false, 5, 16, 2.f);
+  estimator.Accept(kCoarse);
+  EXPECT_EQ(estimator.GetBestEstimateFrameSize(), std::make_pair(324, 180));
+
+  // The multiples of the voted grid are checked as well, so the finer grid
+  // outvotes it
+  for (int i = 0; i < 10; i++) {
+    estimator.Accept(kFine);
+  }
+  EXPECT_TRUE(estimator.HasBestEstimate());
+  EXPECT_EQ(estimator.GetBestEstimateFrameSize(), std::make_pair(108, 60));
+}
+
+TEST(HypothesisEstimatorTests, TestFlatImageHasNoGrid) {
+  mat::Mat2D<uint8_t> mat(90, 160);
+  for (int row = 0; row < mat.GetRowCount(); row++) {
+    for (int col = 0; col < mat.GetColCount(); col++) {
+      mat.SetValue(row, col, 100);
+    }
+  }
+
+  HypothesisEstimator estimator(false, 1, 16, 2.f);
+  estimator.Accept(mat);
+  EXPECT_EQ(estimator.GetBestEstimateFrameSize(), std::make_pair(160, 90));
+}
+
+}  // namespace video_detect
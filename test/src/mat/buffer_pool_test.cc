@@ -0,0 +1,68 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#include "video-detect/mat/buffer_pool.h"
+
+#include <gtest/gtest.h>
+
+#include "video-detect/mat/mat_2d.h"
+
+namespace video_detect {
+namespace mat {
+
+TEST(MatTests, BufferPoolTestReuseReleasedBuffers) {
+  BufferPool<uint8_t> pool;
+  const uint8_t *first_data = nullptr;
+
+  // The first request allocates
+  {
+    Mat2D<uint8_t> mat = pool.Acquire(4, 5);
+    EXPECT_EQ(mat.GetRowCount(), 4);
+    EXPECT_EQ(mat.GetColCount(), 5);
+    EXPECT_EQ(mat.GetStride(), Mat2D<uint8_t>::GetAlignedStride(5));
+    first_data = mat.GetRowPtr(0);
+    mat.SetValue(3, 4, 42);
+  }
+  EXPECT_EQ(pool.GetAllocationCount(), 1u);
+
+  // A released buffer is reused for a request of the same or a smaller size
+  {
+    Mat2D<uint8_t> mat = pool.AcquireZeroed(3, 5);
+    EXPECT_EQ(mat.GetRowPtr(0), first_data);
+    EXPECT_EQ(mat.GetSumOfContents(), 0);
+
+    // A buffer in use is not handed out twice
+    Mat2D<uint8_t> other = pool.Acquire(4, 5);
+    EXPECT_NE(other.GetRowPtr(0), first_data);
+  }
+  EXPECT_EQ(pool.GetAllocationCount(), 2u);
+
+  // Repeating the same sequence of requests does not allocate
+  for (int i = 0; i < 3; i++) {
+    Mat2D<uint8_t> mat = pool.Acquire(4, 5);
+    Mat2D<uint8_t> other = pool.Acquire(4, 5);
+    mat = other + mat;
+  }
+  EXPECT_EQ(pool.GetAllocationCount(), 2u);
+
+  // A larger request needs a new buffer
+  Mat2D<uint8_t> large = pool.Acquire(40, 50);
+  EXPECT_EQ(pool.GetAllocationCount(), 3u);
+}
+
+TEST(MatTests, BufferPoolTestMatOutlivesPool) {
+  Mat2D<int> mat(0, 0);
+  {
+    BufferPool<int> pool;
+    mat = pool.AcquireZeroed(2, 2);
+    mat.SetValue(1, 1, 7);
+  }
+
+  // The buffer is kept alive by the matrix
+  EXPECT_EQ(mat.GetValue(1, 1), 7);
+  EXPECT_EQ(mat.GetSumOfContents(), 7);
+}
+
+}  // namespace mat
+}  // namespace video_detect
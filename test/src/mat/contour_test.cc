@@ -0,0 +1,43 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#include "video-detect/mat/contour.h"
+
+#include <gtest/gtest.h>
+
+#include "video-detect/mat/mat_2d.h"
+
+namespace video_detect {
+namespace mat {
+
+TEST(MatTests, ContourMaskMarksOuterAndHoleBorders) {
+  // A filled square with a hole and a region touching the edge
+  Mat2D<uint8_t> mat({{0, 0, 0, 0, 0, 0, 0, 9},
+                      {0, 7, 7, 7, 7, 7, 0, 9},
+                      {0, 7, 7, 7, 7, 7, 0, 9},
+                      {0, 7, 7, 0, 7, 7, 0, 0},
+                      {0, 7, 7, 7, 7, 7, 0, 0},
+                      {0, 7, 7, 7, 7, 7, 0, 0},
+                      {0, 0, 0, 0, 0, 0, 0, 0}});
+  Mat2D<uint8_t> expected({{0, 0, 0, 0, 0, 0, 0, 255},
+                           {0, 255, 255, 255, 255, 255, 0, 255},
+                           {0, 255, 0, 255, 0, 255, 0, 255},
+                           {0, 255, 255, 0, 255, 255, 0, 0},
+                           {0, 255, 0, 255, 0, 255, 0, 0},
+                           {0, 255, 255, 255, 255, 255, 0, 0},
+                           {0, 0, 0, 0, 0, 0, 0, 0}});
+
+  Mat2D<uint8_t> result(mat.GetRowCount(), mat.GetColCount());
+  ContourMask(mat, result);
+
+  // Test the outer border, the border around the hole and the edge
+  for (int row = 0; row < mat.GetRowCount(); row++) {
+    for (int col = 0; col < mat.GetColCount(); col++) {
+      EXPECT_EQ(result.GetValue(row, col), expected.GetValue(row, col));
+    }
+  }
+}
+
+}  // namespace mat
+}  // namespace video_detect
@@ -6,6 +6,10 @@
 
 #include <gtest/gtest.h>
 
+#include <cstdlib>
+
+#include "video-detect/mat/filter.h"
+#include "video-detect/mat/kernel_defs.h"
 #include "video-detect/mat/mat_2d.h"
 
 namespace video_detect {
@@ -38,5 +42,144 @@ TEST(MatTests, ConvTestConvMat2DMatKernel) {
   EXPECT_EQ(result.GetValue(3, 3), 4);
 }
 
+TEST(MatTests, ConvTestBorderModes) {
+  // Create a test matrix and a box kernel
+  const Mat2D<int> mat{{{1, 2, 3, 4}, {5, 6, 7, 8}, {9, 10, 11, 12}}};
+  const Mat2D<int> kernel{{{1, 1, 1}, {1, 1, 1}, {1, 1, 1}}};
+
+  // Test the corner value for each border mode
+  EXPECT_EQ(ConvMat2D(mat, kernel).GetValue(0, 0), 1 + 2 + 5 + 6);
+  EXPECT_EQ(ConvMat2D(mat, kernel, BorderMode::kReplicate).GetValue(0, 0),
+            (1 + 1 + 2) * 2 + (5 + 5 + 6));
+  EXPECT_EQ(ConvMat2D(mat, kernel, BorderMode::kReflect).GetValue(0, 0),
+            (6 + 5 + 6) * 2 + (2 + 1 + 2));
+
+  // Skipping leaves the border untouched
+  Mat2D<int> result(mat.GetRowCount(), mat.GetColCount());
+  for (int row = 0; row < mat.GetRowCount(); row++) {
+    for (int col = 0; col < mat.GetColCount(); col++) {
+      result.SetValue(row, col, -1);
+    }
+  }
+  ConvMat2D<int>(mat.View(), kernel, result.View(), BorderMode::kSkip);
+  EXPECT_EQ(result.GetValue(0, 0), -1);
+  EXPECT_EQ(result.GetValue(2, 3), -1);
+  EXPECT_EQ(result.GetValue(1, 1), 54);
+  EXPECT_EQ(result.GetValue(1, 2), 63);
+
+  // The separable path gives the same results for every border mode
+  for (BorderMode border : {BorderMode::kZero, BorderMode::kReplicate,
+                            BorderMode::kReflect, BorderMode::kSkip}) {
+    Filter<int> filter(kernel, border);
+    ASSERT_TRUE(filter.IsSeparable());
+    Mat2D<int> separable(mat.GetRowCount(), mat.GetColCount());
+    Mat2D<int> full(mat.GetRowCount(), mat.GetColCount());
+    filter.Apply(mat.View(), separable.View());
+    ConvMat2D<int>(mat.View(), kernel, full.View(), border);
+    for (int row = 0; row < mat.GetRowCount(); row++) {
+      for (int col = 0; col < mat.GetColCount(); col++) {
+        EXPECT_EQ(separable.GetValue(row, col), full.GetValue(row, col));
+      }
+    }
+  }
+}
+
+TEST(MatTests, ConvTestFactorizeKernel) {
+  Mat2D<int8_t> row(0, 0);
+  Mat2D<int8_t> col(0, 0);
+
+  // The Sobel kernels are separable into integral factors
+  ASSERT_TRUE(FactorizeKernel(kSobelY3x3, row, col));
+  EXPECT_EQ(row.GetColCount(), 3);
+  EXPECT_EQ(col.GetRowCount(), 3);
+  for (int y = 0; y < 3; y++) {
+    for (int x = 0; x < 3; x++) {
+      EXPECT_EQ(col.GetValue(y, 0) * row.GetValue(0, x),
+                kSobelY3x3.At(y, x));
+    }
+  }
+  const Filter<uint8_t, int8_t> kSobelFilter(kSobelX3x3);
+  const Filter<uint8_t, float> kGaussianFilter(kKernelGaussian3x3);
+  EXPECT_TRUE(kSobelFilter.IsSeparable());
+  EXPECT_TRUE(kGaussianFilter.IsSeparable());
+
+  // Kernels with a rank above one are not
+  const Mat2D<float> kernel_3x3{
+      {{1.0f, 0.0f, 1.0f}, {0.0f, 1.0f, 0.0f}, {1.0f, 0.0f, 1.0f}}};
+  const Filter<uint8_t, float> kCrossFilter(kernel_3x3);
+  const Filter<uint8_t, float> kGaussian5x5Filter(kKernelGaussian5x5);
+  EXPECT_FALSE(kCrossFilter.IsSeparable());
+  EXPECT_FALSE(kGaussian5x5Filter.IsSeparable());
+}
+
+TEST(MatTests, ConvTestFixedSizeKernel) {
+  // The kernels are compile time constants
+  static_assert(kSobelX3x3.At(1, 0) == -2, "Unexpected kernel value");
+  static_assert(kKernelGaussian5x5.GetRowCount() == 5, "Unexpected size");
+
+  // Create a test matrix
+  Mat2D<uint8_t> mat(11, 13);
+  for (int row = 0; row < mat.GetRowCount(); row++) {
+    for (int col = 0; col < mat.GetColCount(); col++) {
+      mat.SetValue(row, col, static_cast<uint8_t>(row * 31 + col * 17));
+    }
+  }
+
+  // The unrolled convolution equals the run-time sized one
+  Mat2D<uint8_t> fixed = ConvMat2D(mat, kKernelGaussian5x5);
+  Mat2D<uint8_t> dynamic = ConvMat2D(mat, kKernelGaussian5x5.ToMat2D());
+  Filter<uint8_t, int8_t> fixed_filter(kSobelY3x3);
+  Filter<uint8_t, int8_t> dynamic_filter(kSobelY3x3.ToMat2D());
+  Mat2D<uint8_t> fixed_sobel = fixed_filter.Apply(mat);
+  Mat2D<uint8_t> dynamic_sobel = dynamic_filter.Apply(mat);
+  for (int row = 0; row < mat.GetRowCount(); row++) {
+    for (int col = 0; col < mat.GetColCount(); col++) {
+      EXPECT_EQ(fixed.GetValue(row, col), dynamic.GetValue(row, col));
+      EXPECT_EQ(fixed_sobel.GetValue(row, col),
+                dynamic_sobel.GetValue(row, col));
+    }
+  }
+}
+
+TEST(MatTests, ConvTestSeparableMatchesFullKernel) {
+  // Create a test matrix with pseudo random values
+  Mat2D<uint8_t> mat(17, 23);
+  std::srand(42);
+  for (int row = 0; row < mat.GetRowCount(); row++) {
+    for (int col = 0; col < mat.GetColCount(); col++) {
+      mat.SetValue(row, col, static_cast<uint8_t>(std::rand() % 256));
+    }
+  }
+
+  // The integral Sobel kernels give identical results
+  Mat2D<uint8_t> separable(mat.GetRowCount(), mat.GetColCount());
+  SepConvMat2D<uint8_t>(mat.View(), kSobelX3x3Row, kSobelX3x3Col,
+                        separable.View());
+  Mat2D<uint8_t> full = ConvMat2D(mat, kSobelX3x3);
+  for (int row = 0; row < mat.GetRowCount(); row++) {
+    for (int col = 0; col < mat.GetColCount(); col++) {
+      EXPECT_EQ(separable.GetValue(row, col), full.GetValue(row, col));
+    }
+  }
+  separable = Filter<uint8_t, int8_t>(kSobelY3x3).Apply(mat);
+  full = ConvMat2D(mat, kSobelY3x3);
+  for (int row = 0; row < mat.GetRowCount(); row++) {
+    for (int col = 0; col < mat.GetColCount(); col++) {
+      EXPECT_EQ(separable.GetValue(row, col), full.GetValue(row, col));
+    }
+  }
+
+  // The floating point Gaussian kernel only differs by rounding
+  separable = Filter<uint8_t, float>(kKernelGaussian3x3).Apply(mat);
+  full = ConvMat2D(mat, kKernelGaussian3x3);
+  for (int row = 0; row < mat.GetRowCount(); row++) {
+    for (int col = 0; col < mat.GetColCount(); col++) {
+      EXPECT_LE(std::abs(separable.GetValue(row, col) -
+                         full.GetValue(row, col)),
+                1);
+    }
+  }
+}
+
 }  // namespace mat
 }  // namespace video_detect
@@ -0,0 +1,112 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#include "video-detect/mat/conv_u8.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <vector>
+
+#include "video-detect/mat/conv.h"
+#include "video-detect/mat/kernel_defs.h"
+#include "video-detect/mat/mat_2d.h"
+
+namespace video_detect {
+namespace mat {
+
+namespace {
+
+Mat2D<uint8_t> CreateRandomMat(int rows, int cols) {
+  Mat2D<uint8_t> mat(rows, cols);
+  std::srand(7);
+  for (int row = 0; row < rows; row++) {
+    for (int col = 0; col < cols; col++) {
+      mat.SetValue(row, col, static_cast<uint8_t>(std::rand() % 256));
+    }
+  }
+  return mat;
+}
+
+}  // namespace
+
+TEST(MatTests, ConvU8TestFixedPointKernel) {
+  // Integral kernels are held exactly
+  const FixedPointKernel kSobel(kSobelX3x3);
+  EXPECT_EQ(kSobel.GetShift(), 0);
+  EXPECT_EQ(kSobel.GetWeights().GetValue(1, 0), -2);
+
+  // Floating point kernels are scaled
+  const FixedPointKernel kGaussian(kKernelGaussian3x3);
+  EXPECT_EQ(kGaussian.GetShift(), FixedPointKernel::kMaxShift);
+  EXPECT_EQ(kGaussian.GetWeights().GetValue(1, 1), 2731);
+}
+
+TEST(MatTests, ConvU8TestScalarMatchesReference) {
+  Mat2D<uint8_t> mat = CreateRandomMat(13, 19);
+  Mat2D<uint8_t> result(mat.GetRowCount(), mat.GetColCount());
+
+  // The integral kernel gives the saturated convolution
+  Mat2D<int> mat_int(mat.GetRowCount(), mat.GetColCount());
+  for (int row = 0; row < mat.GetRowCount(); row++) {
+    for (int col = 0; col < mat.GetColCount(); col++) {
+      mat_int.SetValue(row, col, mat.GetValue(row, col));
+    }
+  }
+  const Mat2D<int> kSobelY{{{1, 2, 1}, {0, 0, 0}, {-1, -2, -1}}};
+  Mat2D<int> expected = ConvMat2D(mat_int, kSobelY);
+  ConvU8(mat, FixedPointKernel(kSobelY3x3), result, ConvPath::kScalar);
+  for (int row = 0; row < mat.GetRowCount(); row++) {
+    for (int col = 0; col < mat.GetColCount(); col++) {
+      const int kValue = std::max(0, std::min(255, expected.At(row, col)));
+      EXPECT_EQ(result.GetValue(row, col), kValue);
+    }
+  }
+
+  // The floating point kernel only differs by rounding
+  Mat2D<uint8_t> reference = ConvMat2D(mat, kKernelGaussian3x3);
+  ConvU8(mat, FixedPointKernel(kKernelGaussian3x3), result, ConvPath::kScalar);
+  for (int row = 0; row < mat.GetRowCount(); row++) {
+    for (int col = 0; col < mat.GetColCount(); col++) {
+      EXPECT_LE(std::abs(result.GetValue(row, col) -
+                         reference.GetValue(row, col)),
+                1);
+    }
+  }
+}
+
+TEST(MatTests, ConvU8TestAllPathsIdentical) {
+  // Odd sizes exercise the vector tails and the borders
+  Mat2D<uint8_t> mat = CreateRandomMat(37, 53);
+  const std::vector<FixedPointKernel> kKernels{
+      FixedPointKernel(kKernelGaussian3x3),
+      FixedPointKernel(kKernelGaussian5x5), FixedPointKernel(kSobelX3x3),
+      FixedPointKernel(kSobelY3x3)};
+
+  for (const auto &kernel : kKernels) {
+    Mat2D<uint8_t> reference(mat.GetRowCount(), mat.GetColCount());
+    ConvU8(mat, kernel, reference, ConvPath::kScalar);
+
+    for (ConvPath path : {ConvPath::kSse41, ConvPath::kAvx2}) {
+      if (!IsConvPathSupported(path)) {
+        continue;
+      }
+      Mat2D<uint8_t> result(mat.GetRowCount(), mat.GetColCount());
+      ConvU8(mat, kernel, result, path);
+      for (int row = 0; row < mat.GetRowCount(); row++) {
+        for (int col = 0; col < mat.GetColCount(); col++) {
+          ASSERT_EQ(result.GetValue(row, col), reference.GetValue(row, col))
+              << "path " << static_cast<int>(path) << " at " << row << ", "
+              << col;
+        }
+      }
+    }
+  }
+
+  // The default path is one of the supported ones
+  EXPECT_TRUE(IsConvPathSupported(GetDefaultConvPath()));
+}
+
+}  // namespace mat
+}  // namespace video_detect
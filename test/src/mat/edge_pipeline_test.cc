@@ -0,0 +1,57 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#include "video-detect/mat/edge_pipeline.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+
+#include "video-detect/mat/kernel_defs.h"
+#include "video-detect/mat/mat_2d.h"
+
+namespace video_detect {
+namespace mat {
+
+TEST(MatTests, EdgePipelineMatchesStagedFilters) {
+  // Create a test matrix with pseudo random values
+  Mat2D<uint8_t> mat(23, 67);
+  std::srand(5);
+  for (int row = 0; row < mat.GetRowCount(); row++) {
+    for (int col = 0; col < mat.GetColCount(); col++) {
+      mat.SetValue(row, col, static_cast<uint8_t>(std::rand() % 256));
+    }
+  }
+  const FixedPointKernel kGaussian(kKernelGaussian3x3);
+  const Threshold<uint8_t> kThreshold(100, 200, 0, 255);
+
+  // Apply the filters one after the other on the whole image
+  Mat2D<uint8_t> smoothed(mat.GetRowCount(), mat.GetColCount());
+  Mat2D<uint8_t> expected(mat.GetRowCount(), mat.GetColCount());
+  ConvU8(mat, kGaussian, smoothed);
+  kThreshold.Apply(smoothed.View());
+  SobelGradient(smoothed, expected, GradientNorm::kL2);
+
+  // Stream the whole image and a band of rows through the pipeline
+  EdgePipeline pipeline(kGaussian, kThreshold, GradientNorm::kL2);
+  Mat2D<uint8_t> result(mat.GetRowCount(), mat.GetColCount());
+  pipeline.Apply(mat, result);
+  Mat2D<uint8_t> band(6, mat.GetColCount());
+  pipeline.ApplyRows(mat, 9, 15, band);
+
+  // Test that all rows are identical
+  for (int row = 0; row < mat.GetRowCount(); row++) {
+    for (int col = 0; col < mat.GetColCount(); col++) {
+      EXPECT_EQ(result.GetValue(row, col), expected.GetValue(row, col));
+    }
+  }
+  for (int row = 0; row < band.GetRowCount(); row++) {
+    for (int col = 0; col < band.GetColCount(); col++) {
+      EXPECT_EQ(band.GetValue(row, col), expected.GetValue(row + 9, col));
+    }
+  }
+}
+
+}  // namespace mat
+}  // namespace video_detect
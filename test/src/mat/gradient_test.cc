@@ -0,0 +1,81 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#include "video-detect/mat/gradient.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#include "video-detect/mat/conv.h"
+#include "video-detect/mat/kernel_defs.h"
+#include "video-detect/mat/mat_2d.h"
+
+namespace video_detect {
+namespace mat {
+
+TEST(MatTests, GradientTestMatchesSobelConvolution) {
+  // Create a test matrix with pseudo random values and its int copy
+  Mat2D<uint8_t> mat(9, 21);
+  Mat2D<int> mat_int(mat.GetRowCount(), mat.GetColCount());
+  std::srand(3);
+  for (int row = 0; row < mat.GetRowCount(); row++) {
+    for (int col = 0; col < mat.GetColCount(); col++) {
+      const int kValue = std::rand() % 256;
+      mat.SetValue(row, col, static_cast<uint8_t>(kValue));
+      mat_int.SetValue(row, col, kValue);
+    }
+  }
+
+  // Calculate the reference gradients without truncation
+  const Mat2D<int> kSobelX = Kernel<int, 3, 3>{
+      {{-1, 0, 1}, {-2, 0, 2}, {-1, 0, 1}}}.ToMat2D();
+  const Mat2D<int> kSobelY = Kernel<int, 3, 3>{
+      {{1, 2, 1}, {0, 0, 0}, {-1, -2, -1}}}.ToMat2D();
+  Mat2D<int> gx = ConvMat2D(mat_int, kSobelX);
+  Mat2D<int> gy = ConvMat2D(mat_int, kSobelY);
+
+  // Calculate the magnitudes
+  Mat2D<uint8_t> l1(mat.GetRowCount(), mat.GetColCount());
+  Mat2D<uint8_t> l2(mat.GetRowCount(), mat.GetColCount());
+  SobelGradient(mat.View(), l1.View(), GradientNorm::kL1);
+  SobelGradient(mat.View(), l2.View(), GradientNorm::kL2);
+
+  for (int row = 0; row < mat.GetRowCount(); row++) {
+    for (int col = 0; col < mat.GetColCount(); col++) {
+      const int kX = gx.GetValue(row, col);
+      const int kY = gy.GetValue(row, col);
+      EXPECT_EQ(l1.GetValue(row, col),
+                std::min(255, std::abs(kX) + std::abs(kY)));
+      const int kRoot = static_cast<int>(std::sqrt(1.0 * (kX * kX + kY * kY)));
+      EXPECT_EQ(l2.GetValue(row, col), std::min(255, kRoot));
+    }
+  }
+}
+
+TEST(MatTests, GradientTestDirection) {
+  // A vertical edge (dark to bright from left to right) and a horizontal edge
+  // (bright above dark)
+  Mat2D<uint8_t> vertical{{{0, 0, 9, 9}, {0, 0, 9, 9}, {0, 0, 9, 9}}};
+  Mat2D<uint8_t> horizontal{{{9, 9, 9}, {9, 9, 9}, {0, 0, 0}, {0, 0, 0}}};
+  Mat2D<uint8_t> magnitude(3, 4);
+  Mat2D<uint8_t> direction(3, 4);
+
+  // The gradient points along the positive x-axis
+  SobelGradient(vertical.View(), magnitude.View(), direction.View());
+  EXPECT_EQ(magnitude.GetValue(1, 1), 36);
+  EXPECT_EQ(direction.GetValue(1, 1), 0);
+
+  // The gradient points along the positive y-axis, a quarter turn
+  magnitude.Resize(4, 3);
+  direction.Resize(4, 3);
+  SobelGradient(horizontal.View(), magnitude.View(), direction.View());
+  EXPECT_EQ(magnitude.GetValue(1, 1), 36);
+  EXPECT_EQ(direction.GetValue(1, 1), 64);
+}
+
+}  // namespace mat
+}  // namespace video_detect
@@ -0,0 +1,123 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#include "video-detect/mat/line_features.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+
+#include "video-detect/mat/mat_2d.h"
+
+namespace video_detect {
+namespace mat {
+
+namespace {
+
+/**
+ * Mark the lines of one direction with the original column by column scan
+ */
+void MarkLines(const Mat2D<uint8_t> &mat, int length, bool vertical,
+               Mat2D<uint8_t> &mask) {  // NOLINT(runtime/references)
+  const int kLines = vertical ? mat.GetColCount() : mat.GetRowCount();
+  const int kPixels = vertical ? mat.GetRowCount() : mat.GetColCount();
+  for (int line = 0; line < kLines; line++) {
+    int counter = 0;
+    for (int i = 0; i < kPixels; i++) {
+      const int kValue =
+          vertical ? mat.GetValue(i, line) : mat.GetValue(line, i);
+      if (kValue == 255) {
+        ++counter;
+      } else if (counter >= length) {
+        for (int j = i - counter; j <= i; j++) {
+          vertical ? mask.SetValue(j, line, 255) : mask.SetValue(line, j, 255);
+        }
+        counter = 0;
+      } else {
+        counter = 0;
+      }
+    }
+  }
+}
+
+}  // namespace
+
+TEST(MatTests, LineFeatureFinderMatchesColumnScan) {
+  // Create a sparse mask with long horizontal and vertical lines
+  Mat2D<uint8_t> mat(60, 70);
+  std::srand(11);
+  for (int i = 0; i < 40; i++) {
+    const int kRow = std::rand() % 60;
+    const int kCol = std::rand() % 70;
+    const int kLength = 10 + std::rand() % 30;
+    for (int j = 0; j < kLength; j++) {
+      if (i % 2 == 0) {
+        mat.SetValue(kRow, kCol + j, 255);
+      } else {
+        mat.SetValue(kRow + j, kCol, 255);
+      }
+    }
+  }
+
+  // Find the lines and their reference
+  Mat2D<uint8_t> expected(60, 70);
+  MarkLines(mat, 20, false, expected);
+  MarkLines(mat, 15, true, expected);
+  LineFeatureFinder finder(20, 15);
+  Mat2D<uint8_t> result(60, 70);
+  finder.Apply(mat, result);
+
+  // Test the mask and that the segments cover exactly the mask
+  Mat2D<uint8_t> segments(60, 70);
+  for (const LineSegment &line : finder.GetHorizontalLines()) {
+    EXPECT_GE(line.length, 21);
+    for (int col = line.col; col < line.col + line.length; col++) {
+      segments.SetValue(line.row, col, 255);
+    }
+  }
+  for (const LineSegment &line : finder.GetVerticalLines()) {
+    EXPECT_GE(line.length, 16);
+    for (int row = line.row; row < line.row + line.length; row++) {
+      segments.SetValue(row, line.col, 255);
+    }
+  }
+  EXPECT_FALSE(finder.GetHorizontalLines().empty());
+  EXPECT_FALSE(finder.GetVerticalLines().empty());
+  for (int row = 0; row < mat.GetRowCount(); row++) {
+    for (int col = 0; col < mat.GetColCount(); col++) {
+      EXPECT_EQ(result.GetValue(row, col), expected.GetValue(row, col));
+      EXPECT_EQ(segments.GetValue(row, col), expected.GetValue(row, col));
+    }
+  }
+}
+
+TEST(MatTests, LineCrossingsMatchWindowScan) {
+  // Create a dense random mask so that many windows are near the threshold
+  Mat2D<uint8_t> mat(40, 50);
+  std::srand(13);
+  for (int row = 0; row < mat.GetRowCount(); row++) {
+    for (int col = 0; col < mat.GetColCount(); col++) {
+      mat.SetValue(row, col, std::rand() % 2 == 0 ? 255 : 0);
+    }
+  }
+  Mat2D<uint8_t> result(40, 50);
+  FindLineCrossings(mat, 10, 10, result);
+
+  // Test every pixel against counting its 21 pixel windows
+  for (int row = 0; row < mat.GetRowCount(); row++) {
+    for (int col = 0; col < mat.GetColCount(); col++) {
+      int count_h = 0;
+      int count_v = 0;
+      for (int i = -10; i <= 10; i++) {
+        count_h += mat.GetValue(row, col + i) == 255;
+        count_v += mat.GetValue(row + i, col) == 255;
+      }
+      const int kExpected = count_h >= 10 && count_v >= 10 ? 255 : 0;
+      EXPECT_EQ(result.GetValue(row, col), kExpected);
+    }
+  }
+}
+
+}  // namespace mat
+}  // namespace video_detect
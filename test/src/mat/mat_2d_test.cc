@@ -6,6 +6,9 @@
 
 #include <gtest/gtest.h>
 
+#include <memory>
+#include <vector>
+
 namespace video_detect {
 namespace mat {
 
@@ -33,6 +36,59 @@ TEST(MatTests, MatTestCreateAndGetAttributes) {
   EXPECT_EQ(mat.GetValue(-2, -2), int());
 }
 
+TEST(MatTests, MatTestContiguousRowAlignedStorage) {
+  // Create Mat2D
+  Mat2D<uint8_t> mat({{0, 1, 2}, {3, 4, 5}});
+
+  // Test that each row starts at an aligned address after the previous row
+  EXPECT_GE(mat.GetStride(), mat.GetColCount());
+  EXPECT_EQ(mat.GetRowPtr(1) - mat.GetRowPtr(0), mat.GetStride());
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(mat.GetRowPtr(1)) % kMatAlignment, 0);
+
+  // Test unchecked access
+  EXPECT_EQ(mat.At(1, 2), 5);
+  mat.At(1, 2) = 9;
+  EXPECT_EQ(mat.GetRowPtr(1)[2], 9);
+
+  // Test that resizing keeps the overlapping values
+  mat.Resize(3, 4);
+  EXPECT_EQ(mat.GetRowCount(), 3);
+  EXPECT_EQ(mat.GetColCount(), 4);
+  EXPECT_EQ(mat.GetValue(0, 1), 1);
+  EXPECT_EQ(mat.GetValue(1, 2), 9);
+  EXPECT_EQ(mat.GetValue(1, 3), 0);
+  EXPECT_EQ(mat.GetValue(2, 0), 0);
+}
+
+TEST(MatTests, MatTestWrapExternalStorage) {
+  // Create external storage with a stride of 4 values
+  auto storage = std::make_shared<std::vector<int>>(
+      std::vector<int>{0, 1, 2, -1, 3, 4, 5, -1});
+
+  // Wrap the storage without copying
+  Mat2D<int> mat(storage->data(), 2, 3, 4, storage);
+  EXPECT_EQ(mat.GetValue(1, 2), 5);
+  EXPECT_EQ(mat.GetRowPtr(1), storage->data() + 4);
+
+  // Test that the matrix keeps the storage alive
+  std::weak_ptr<std::vector<int>> weak_storage = storage;
+  storage.reset();
+  EXPECT_FALSE(weak_storage.expired());
+
+  // Test that a copy is a deep copy
+  Mat2D<int> copy = mat;
+  copy.SetValue(0, 0, 42);
+  EXPECT_EQ(mat.GetValue(0, 0), 0);
+  EXPECT_NE(copy.GetRowPtr(0), mat.GetRowPtr(0));
+
+  // Test that a move transfers the storage
+  Mat2D<int> moved = std::move(mat);
+  EXPECT_EQ(moved.GetValue(1, 0), 3);
+  EXPECT_FALSE(weak_storage.expired());
+  moved = Mat2D<int>(1, 1);
+  EXPECT_TRUE(weak_storage.expired());
+}
+
 TEST(MatTests, MatTestGetSum) {
   // Create Mat2D
   Mat2D<int> mat_int({{0, 1, 2}, {3, 4, 5}, {6, 7, 8}});
@@ -0,0 +1,83 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#include "video-detect/mat/mat_2d_view.h"
+
+#include <gtest/gtest.h>
+
+#include "video-detect/mat/conv.h"
+#include "video-detect/mat/mat_2d.h"
+#include "video-detect/mat/threshold.h"
+
+namespace video_detect {
+namespace mat {
+
+TEST(MatTests, MatViewTestSliceWithoutCopy) {
+  // Create Mat2D
+  Mat2D<int> mat({{0, 1, 2, 3}, {4, 5, 6, 7}, {8, 9, 10, 11}});
+
+  // Create a view onto the lower right 2x2 values
+  Mat2DView<int> view = mat.View().Slice(1, 2, 2, 2);
+
+  // Test sizes
+  EXPECT_EQ(view.GetRowCount(), 2);
+  EXPECT_EQ(view.GetColCount(), 2);
+  EXPECT_EQ(view.GetStride(), mat.GetStride());
+
+  // Test values
+  EXPECT_EQ(view.GetValue(0, 0), 6);
+  EXPECT_EQ(view.GetValue(0, 1), 7);
+  EXPECT_EQ(view.GetValue(1, 0), 10);
+  EXPECT_EQ(view.GetValue(1, 1), 11);
+  EXPECT_EQ(view.GetValue(2, 0), int());
+  EXPECT_EQ(view.GetValue(-1, 0), int());
+
+  // Test that the view writes into the matrix
+  view.SetValue(1, 1, 42);
+  EXPECT_EQ(mat.GetValue(2, 3), 42);
+
+  // Test that slices are clipped to the bounds
+  Mat2DView<const int> clipped = mat.View().Slice(2, 3, 5, 5);
+  EXPECT_EQ(clipped.GetRowCount(), 1);
+  EXPECT_EQ(clipped.GetColCount(), 1);
+  EXPECT_EQ(clipped.GetValue(0, 0), 42);
+}
+
+TEST(MatTests, MatViewTestThresholdOnRegionOfInterest) {
+  // Create Mat2D
+  Mat2D<uint8_t> mat({{50, 50, 50}, {50, 150, 250}, {50, 250, 150}});
+
+  // Apply the threshold in place on the lower right 2x2 values only
+  Threshold<uint8_t> threshold(100, 200, 0, 255);
+  Mat2DView<uint8_t> roi = mat.View().Slice(1, 1, 2, 2);
+  threshold.Apply(roi, roi);
+
+  // Test that only the region of interest changed
+  EXPECT_EQ(mat.GetValue(0, 0), 50);
+  EXPECT_EQ(mat.GetValue(1, 0), 50);
+  EXPECT_EQ(mat.GetValue(1, 1), 150);
+  EXPECT_EQ(mat.GetValue(1, 2), 255);
+  EXPECT_EQ(mat.GetValue(2, 1), 255);
+  EXPECT_EQ(mat.GetValue(2, 2), 150);
+}
+
+TEST(MatTests, MatViewTestConvIntoView) {
+  // Create Mat2D
+  Mat2D<uint8_t> mat({{1, 1, 1}, {1, 1, 1}, {1, 1, 1}});
+  const Mat2D<float> kernel(
+      {{1.f, 1.f, 1.f}, {1.f, 1.f, 1.f}, {1.f, 1.f, 1.f}});
+
+  // Convolute the full matrix into a view onto a larger matrix
+  Mat2D<uint8_t> result(4, 4);
+  ConvMat2D<uint8_t>(mat, kernel, result.View().Slice(1, 1, 3, 3));
+
+  // Test the expected
+  EXPECT_EQ(result.GetValue(0, 0), 0);
+  EXPECT_EQ(result.GetValue(1, 1), 4);
+  EXPECT_EQ(result.GetValue(2, 2), 9);
+  EXPECT_EQ(result.GetValue(3, 2), 6);
+}
+
+}  // namespace mat
+}  // namespace video_detect
@@ -0,0 +1,87 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#include "video-detect/mat/mat_expr.h"
+
+#include <gtest/gtest.h>
+
+#include "video-detect/mat/mat_2d.h"
+
+namespace video_detect {
+namespace mat {
+
+namespace {
+
+Mat2D<uint8_t> CreateTemporary() {
+  return Mat2D<uint8_t>({{3, 4}, {6, 8}});
+}
+
+}  // namespace
+
+TEST(MatTests, MatExprTestFusedMagnitude) {
+  // Create Mat2D
+  Mat2D<uint8_t> x({{3, 0}, {6, 5}});
+  Mat2D<uint8_t> y({{4, 0}, {8, 12}});
+
+  // Calculate the magnitude from uint8 values in a single pass
+  auto x_mat = x.CastTo<float>();
+  auto y_mat = y.CastTo<float>();
+  Mat2D<uint8_t> result =
+      ((x_mat * x_mat) + (y_mat * y_mat)).Sqrt().CastTo<uint8_t>();
+
+  // Test the expected
+  EXPECT_EQ(result.GetValue(0, 0), 5);
+  EXPECT_EQ(result.GetValue(0, 1), 0);
+  EXPECT_EQ(result.GetValue(1, 0), 10);
+  EXPECT_EQ(result.GetValue(1, 1), 13);
+}
+
+TEST(MatTests, MatExprTestTemporariesAreHeldByValue) {
+  // The temporary matrix is moved into the expression
+  auto expr = CreateTemporary().CastTo<int>() * CreateTemporary().CastTo<int>();
+
+  // Test the expected
+  Mat2D<int> result = expr;
+  EXPECT_EQ(result.GetValue(0, 0), 9);
+  EXPECT_EQ(result.GetValue(1, 1), 64);
+}
+
+TEST(MatTests, MatExprTestAssignReusesBuffer) {
+  // Create Mat2D
+  Mat2D<int> mat({{1, 2}, {3, 4}});
+  const int *data = mat.GetRowPtr(0);
+
+  // Assign an expression reading the destination itself
+  mat = mat * mat + mat;
+
+  // Test the buffer is reused and the expected
+  EXPECT_EQ(mat.GetRowPtr(0), data);
+  EXPECT_EQ(mat.GetValue(0, 0), 2);
+  EXPECT_EQ(mat.GetValue(0, 1), 6);
+  EXPECT_EQ(mat.GetValue(1, 0), 12);
+  EXPECT_EQ(mat.GetValue(1, 1), 20);
+}
+
+TEST(MatTests, MatExprTestViewsAndDifferentSizes) {
+  // Create Mat2D
+  Mat2D<int> mat({{1, 2, 3}, {4, 5, 6}});
+  Mat2D<int> other(1, 1);
+  other.SetValue(0, 0, 10);
+
+  // Values outside the right matrix are treated as zero
+  Mat2D<int> result = mat + other;
+  EXPECT_EQ(result.GetRowCount(), 2);
+  EXPECT_EQ(result.GetColCount(), 3);
+  EXPECT_EQ(result.GetValue(0, 0), 11);
+  EXPECT_EQ(result.GetValue(1, 2), 6);
+
+  // Views take part in expressions
+  Mat2DView<int> view = mat.View().Slice(0, 1, 2, 2);
+  Mat2D<int> sliced = view * view;
+  EXPECT_EQ(sliced.GetValue(0, 0), 4);
+  EXPECT_EQ(sliced.GetValue(1, 1), 36);
+}
+
+}  // namespace mat
+}  // namespace video_detect
@@ -0,0 +1,69 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#include "video-detect/mat/projection.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <vector>
+
+#include "video-detect/mat/mat_2d.h"
+
+namespace video_detect {
+namespace mat {
+
+TEST(MatTests, ProjectionTestGradientSums) {
+  // More rows than fit in one uint16 chunk of column sums, with maximal
+  // gradients in every other column
+  Mat2D<uint8_t> mat(300, 45);
+  std::srand(11);
+  for (int row = 0; row < mat.GetRowCount(); row++) {
+    for (int col = 0; col < mat.GetColCount(); col++) {
+      const bool kStripe = col < 10;
+      mat.SetValue(row, col, kStripe ? (col % 2) * 255 : std::rand() % 256);
+    }
+  }
+
+  // Sum the gradients of every row and every column
+  std::vector<uint32_t> expected_rows(mat.GetRowCount(), 0);
+  std::vector<uint32_t> expected_cols(mat.GetColCount(), 0);
+  for (int row = 0; row < mat.GetRowCount(); row++) {
+    for (int col = 0; col < mat.GetColCount(); col++) {
+      if (row > 0) {
+        expected_rows[row] +=
+            std::abs(mat.GetValue(row, col) - mat.GetValue(row - 1, col));
+      }
+      if (col > 0) {
+        expected_cols[col] +=
+            std::abs(mat.GetValue(row, col) - mat.GetValue(row, col - 1));
+      }
+    }
+  }
+
+  // Every path in two ranges of rows
+  for (ProjectionPath path : {ProjectionPath::kScalar, ProjectionPath::kAvx2}) {
+    if (!IsProjectionPathSupported(path)) {
+      continue;
+    }
+    std::vector<uint32_t> row_profile(mat.GetRowCount(), 0);
+    std::vector<uint32_t> col_profile(mat.GetColCount(), 0);
+    ProjectGradientRows(mat, 0, 100, row_profile.data(), col_profile.data(),
+                        path);
+    ProjectGradientRows(mat, 100, 300, row_profile.data() + 100,
+                        col_profile.data(), path);
+    EXPECT_EQ(row_profile, expected_rows);
+    EXPECT_EQ(col_profile, expected_cols);
+  }
+
+  // The parallel projection gives the same sums
+  std::vector<uint32_t> row_profile;
+  std::vector<uint32_t> col_profile;
+  ProjectGradients(mat, &row_profile, &col_profile);
+  EXPECT_EQ(row_profile, expected_rows);
+  EXPECT_EQ(col_profile, expected_cols);
+}
+
+}  // namespace mat
+}  // namespace video_detect
@@ -0,0 +1,101 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#include "video-detect/mat/threshold.h"
+
+#include <gtest/gtest.h>
+
+#include <utility>
+#include <vector>
+
+#include "video-detect/mat/lut_u8.h"
+#include "video-detect/mat/mat_2d.h"
+
+namespace video_detect {
+namespace mat {
+
+TEST(MatTests, ThresholdMultipleRangesMatchGenericPath) {
+  // Create every uint8 value in a row with an odd length to hit the tails
+  Mat2D<uint8_t> mat(3, 91);
+  Mat2D<int> mat_int(3, 91);
+  for (int row = 0; row < mat.GetRowCount(); row++) {
+    for (int col = 0; col < mat.GetColCount(); col++) {
+      const int kValue = (row * 91 + col) % 256;
+      mat.SetValue(row, col, static_cast<uint8_t>(kValue));
+      mat_int.SetValue(row, col, kValue);
+    }
+  }
+
+  // The uint8 threshold uses the lookup table, the int one the range search
+  std::vector<std::pair<uint8_t, uint8_t>> ranges{{20, 40}, {100, 200}};
+  Threshold<uint8_t> threshold(ranges, 1, 254);
+  Threshold<int> threshold_int({{20, 40}, {100, 200}}, 1, 254);
+  Mat2D<uint8_t> result = threshold.Apply(mat);
+  Mat2D<int> result_int = threshold_int.Apply(mat_int);
+
+  // Test the values against the generic path and a few known values
+  for (int row = 0; row < mat.GetRowCount(); row++) {
+    for (int col = 0; col < mat.GetColCount(); col++) {
+      EXPECT_EQ(result.GetValue(row, col), result_int.GetValue(row, col));
+    }
+  }
+  EXPECT_EQ(result.GetValue(0, 10), 1);
+  EXPECT_EQ(result.GetValue(0, 30), 30);
+  EXPECT_EQ(result.GetValue(0, 50), 1);
+  EXPECT_EQ(result.GetValue(1, 59), 150);
+  EXPECT_EQ(result.GetValue(2, 58), 254);
+
+  // Test that the in place application gives the same values
+  threshold.Apply(mat.View());
+  for (int row = 0; row < mat.GetRowCount(); row++) {
+    for (int col = 0; col < mat.GetColCount(); col++) {
+      EXPECT_EQ(mat.GetValue(row, col), result.GetValue(row, col));
+    }
+  }
+
+  // Test that applying a single row on the calling thread gives the same
+  // values in both paths
+  threshold_int.ApplyRows(mat_int.View().SliceRows(1, 1));
+  for (int col = 0; col < mat.GetColCount(); col++) {
+    EXPECT_EQ(mat_int.GetValue(1, col), result.GetValue(1, col));
+  }
+  threshold.ApplyRows(mat.View().SliceRows(1, 1));
+  for (int col = 0; col < mat.GetColCount(); col++) {
+    EXPECT_EQ(mat.GetValue(1, col), result.GetValue(1, col));
+  }
+}
+
+TEST(MatTests, LutU8PathsAreIdentical) {
+  // Create a table which is different for every value
+  LutU8 lut;
+  for (int value = 0; value < 256; value++) {
+    lut[value] = static_cast<uint8_t>(value * 37 + 11);
+  }
+  Mat2D<uint8_t> mat(2, 301);
+  for (int row = 0; row < mat.GetRowCount(); row++) {
+    for (int col = 0; col < mat.GetColCount(); col++) {
+      mat.SetValue(row, col, static_cast<uint8_t>(row * 301 + col));
+    }
+  }
+
+  // Test every supported path against the scalar one
+  Mat2D<uint8_t> expected(2, 301);
+  ApplyLutU8(mat, lut, expected, LutPath::kScalar);
+  for (LutPath path : {LutPath::kSsse3, LutPath::kAvx2}) {
+    if (!IsLutPathSupported(path)) {
+      continue;
+    }
+    Mat2D<uint8_t> result(2, 301);
+    ApplyLutU8(mat, lut, result, path);
+    for (int row = 0; row < mat.GetRowCount(); row++) {
+      for (int col = 0; col < mat.GetColCount(); col++) {
+        EXPECT_EQ(result.GetValue(row, col), expected.GetValue(row, col));
+        EXPECT_EQ(expected.GetValue(row, col), lut[mat.GetValue(row, col)]);
+      }
+    }
+  }
+}
+
+}  // namespace mat
+}  // namespace video_detect
@@ -9,6 +9,7 @@
 #include <opencv2/core/mat.hpp>
 
 #include "video-detect/mat/mat_2d.h"
+#include "video-detect/opencv2/util.h"
 
 
 namespace video_detect {
@@ -37,5 +38,37 @@ TEST(OpenCv2Tests, TestCvMatToMat2DAdapter) {
   EXPECT_EQ(result.GetValue(2, 2), 9);
 }
 
+TEST(OpenCv2Tests, TestCvMatToMat2DAdapterSharesData) {
+  mat::Mat2D<uint8_t> result(1, 1);
+  {
+    // Create a single channel matrix owning its data
+    cv::Mat_<uint8_t> opencv_mat(2, 3);
+    opencv_mat << 1, 2, 3, 4, 5, 6;
+
+    // Adapt without copying
+    result = Mat2DAdapter<uint8_t>(opencv_mat);
+    EXPECT_EQ(result.GetRowPtr(0), opencv_mat.ptr<uint8_t>(0));
+    EXPECT_EQ(result.GetRowPtr(1), opencv_mat.ptr<uint8_t>(1));
+  }
+
+  // Test that the data outlives the cv::Mat
+  EXPECT_EQ(result.GetValue(0, 0), 1);
+  EXPECT_EQ(result.GetValue(1, 2), 6);
+}
+
+TEST(OpenCv2Tests, TestMat2DToCvMatWrapper) {
+  mat::Mat2D<uint8_t> mat({{1, 2, 3}, {4, 5, 6}});
+
+  // Wrap without copying
+  cv::Mat opencv_mat = WrapMat2DInCvMat(mat);
+  EXPECT_EQ(opencv_mat.ptr<uint8_t>(1), mat.GetRowPtr(1));
+  EXPECT_EQ(opencv_mat.at<uint8_t>(1, 2), 6);
+
+  // Copy
+  cv::Mat opencv_copy = ConvertMat2DToCvMat(mat);
+  EXPECT_NE(opencv_copy.ptr<uint8_t>(0), mat.GetRowPtr(0));
+  EXPECT_EQ(opencv_copy.at<uint8_t>(1, 0), 4);
+}
+
 }  // namespace opencv2
 }  // namespace video_detect
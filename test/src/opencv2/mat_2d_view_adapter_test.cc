@@ -0,0 +1,71 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#include "video-detect/opencv2/mat_2d_view_adapter.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include <opencv2/core/mat.hpp>
+
+namespace video_detect {
+namespace opencv2 {
+
+TEST(OpenCv2Tests, TestCvMatToMat2DViewAdapter) {
+  cv::Mat_<uint8_t> opencv_mat(2, 3);
+  opencv_mat << 1, 2, 3, 4, 5, 6;
+
+  // View the values without copying them
+  const Mat2DViewAdapter<const uint8_t> kView(opencv_mat);
+  EXPECT_EQ(kView.GetData(), opencv_mat.ptr<uint8_t>(0));
+  EXPECT_EQ(kView.GetRowCount(), 2);
+  EXPECT_EQ(kView.GetColCount(), 3);
+  EXPECT_EQ(kView.GetStride(), 3);
+  EXPECT_EQ(kView.GetValue(0, 0), 1);
+  EXPECT_EQ(kView.GetValue(1, 2), 6);
+}
+
+TEST(OpenCv2Tests, TestCvMatRegionToMat2DViewAdapter) {
+  cv::Mat_<uint8_t> opencv_mat(4, 5);
+  for (int row = 0; row < opencv_mat.rows; row++) {
+    for (int col = 0; col < opencv_mat.cols; col++) {
+      opencv_mat(row, col) = static_cast<uint8_t>(10 * row + col);
+    }
+  }
+
+  // A region of interest is not continuous, its rows are step[0] apart
+  const cv::Mat kRegion = opencv_mat(cv::Rect(1, 1, 3, 2));
+  ASSERT_FALSE(kRegion.isContinuous());
+  const Mat2DViewAdapter<uint8_t> kView(kRegion);
+  EXPECT_EQ(kView.GetRowCount(), 2);
+  EXPECT_EQ(kView.GetColCount(), 3);
+  EXPECT_EQ(kView.GetStride(), 5);
+  EXPECT_EQ(kView.GetValue(0, 0), 11);
+  EXPECT_EQ(kView.GetValue(1, 2), 23);
+
+  // Writes through the view are visible in the cv::Mat
+  kView.SetValue(1, 0, 99);
+  EXPECT_EQ(opencv_mat(2, 1), 99);
+
+  // The stride of wider values is counted in values, not bytes
+  cv::Mat_<float> opencv_float(3, 4, 1.f);
+  const Mat2DViewAdapter<const float> kFloatView(
+      opencv_float(cv::Rect(1, 0, 2, 3)));
+  EXPECT_EQ(kFloatView.GetStride(), 4);
+  EXPECT_EQ(kFloatView.GetValue(2, 1), 1.f);
+}
+
+TEST(OpenCv2Tests, TestMat2DViewAdapterRejectsOtherElements) {
+  // Several channels or another value type result in an empty view
+  const cv::Mat kColor(2, 3, CV_8UC3, cv::Scalar(1, 2, 3));
+  EXPECT_TRUE(Mat2DViewAdapter<const uint8_t>(kColor).IsEmpty());
+
+  const cv::Mat kShort(2, 3, CV_16UC1, cv::Scalar(1));
+  EXPECT_TRUE(Mat2DViewAdapter<const uint8_t>(kShort).IsEmpty());
+  EXPECT_TRUE(Mat2DViewAdapter<const float>(kShort).IsEmpty());
+}
+
+}  // namespace opencv2
+}  // namespace video_detect
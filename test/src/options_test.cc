@@ -0,0 +1,70 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#include "video-detect/options.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+
+namespace video_detect {
+
+TEST(OptionsTests, TestParseSampleInterval) {
+  Options seconds;
+  const char *kSeconds[] = {"video-detect", "--infile", "video.mp4",
+                            "--sample-every", "5s"};
+  EXPECT_TRUE(seconds.Parse(5, kSeconds));
+  EXPECT_DOUBLE_EQ(seconds.GetSampleInterval(), 5.);
+  EXPECT_TRUE(seconds.IsSampling());
+
+  Options decimal;
+  const char *kDecimal[] = {"video-detect", "--infile", "video.mp4",
+                            "--sample-every", "2.5"};
+  EXPECT_TRUE(decimal.Parse(5, kDecimal));
+  EXPECT_DOUBLE_EQ(decimal.GetSampleInterval(), 2.5);
+}
+
+TEST(OptionsTests, TestParseSampleCount) {
+  Options options;
+  const char *kArgs[] = {"video-detect", "--infile", "video.mp4", "--samples",
+                         "8"};
+  EXPECT_TRUE(options.Parse(5, kArgs));
+  EXPECT_EQ(options.GetSampleCount(), 8);
+  EXPECT_TRUE(options.IsSampling());
+
+  // Without sampling every frame is decoded
+  Options none;
+  const char *kNone[] = {"video-detect", "--infile", "video.mp4"};
+  EXPECT_TRUE(none.Parse(3, kNone));
+  EXPECT_FALSE(none.IsSampling());
+}
+
+TEST(OptionsTests, TestRejectInvalidSampling) {
+  // Only seconds are accepted as the unit of the interval
+  const char *kMinutes[] = {"video-detect", "--infile", "video.mp4",
+                            "--sample-every", "5m"};
+  EXPECT_EXIT(Options().Parse(5, kMinutes),
+              ::testing::ExitedWithCode(EXIT_FAILURE), "");
+  const char *kMilliseconds[] = {"video-detect", "--infile", "video.mp4",
+                                 "--sample-every", "5ms"};
+  EXPECT_EXIT(Options().Parse(5, kMilliseconds),
+              ::testing::ExitedWithCode(EXIT_FAILURE), "");
+
+  // Negative values, both ways of sampling at once and sampling segments are
+  // rejected
+  const char *kNegative[] = {"video-detect", "--infile", "video.mp4",
+                             "--samples", "-1"};
+  EXPECT_EXIT(Options().Parse(5, kNegative),
+              ::testing::ExitedWithCode(EXIT_FAILURE), "");
+  const char *kBoth[] = {"video-detect", "--infile", "video.mp4",
+                         "--sample-every", "5", "--samples", "8"};
+  EXPECT_EXIT(Options().Parse(7, kBoth),
+              ::testing::ExitedWithCode(EXIT_FAILURE), "");
+  const char *kSegments[] = {"video-detect", "--infile", "video.mp4",
+                             "--samples", "8", "--segments", "2"};
+  EXPECT_EXIT(Options().Parse(7, kSegments),
+              ::testing::ExitedWithCode(EXIT_FAILURE), "");
+}
+
+}  // namespace video_detect
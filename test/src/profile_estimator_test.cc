@@ -0,0 +1,72 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#include "video-detect/profile_estimator.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "video-detect/grid_of_frames.h"
+#include "video-detect/mat/mat_2d.h"
+
+namespace video_detect {
+
+TEST(ProfileEstimatorTests, TestGridCountFromProfilePeaks) {
+  // A flat profile has no grid
+  std::vector<uint32_t> profile(240, 100);
+  EXPECT_EQ(ProfileEstimator::FindGridCount(profile, 16), 1);
+
+  // Peaks at a third and two thirds, one of them a pixel off
+  profile[80] = 1000;
+  profile[161] = 1000;
+  EXPECT_EQ(ProfileEstimator::FindGridCount(profile, 16), 3);
+
+  // Adding the boundaries at a sixth makes it six frames, unless capped
+  profile[40] = 1000;
+  profile[120] = 1000;
+  profile[200] = 1000;
+  EXPECT_EQ(ProfileEstimator::FindGridCount(profile, 16), 6);
+  EXPECT_EQ(ProfileEstimator::FindGridCount(profile, 5), 3);
+}
+
+TEST(ProfileEstimatorTests, TestEstimateGridOfFrames) {
+  const mat::Mat2D<uint8_t> mat = MakeGridOfFrames();
+
+  ProfileEstimator estimator(false, 3, 16);
+  for (int i = 0; i < 2; i++) {
+    estimator.Accept(mat);
+  }
+  EXPECT_FALSE(estimator.HasBestEstimate());
+
+  // The estimate is accepted once enough frames voted for it
+  estimator.Accept(mat);
+  EXPECT_TRUE(estimator.HasBestEstimate());
+  EXPECT_EQ(estimator.GetBestEstimateFrameSize(), std::make_pair(160, 120));
+}
+
+TEST(ProfileEstimatorTests, TestMergeEstimatorsOfSegments) {
+  const mat::Mat2D<uint8_t> mat = MakeGridOfFrames();
+
+  // Neither segment has enough frames on its own
+  ProfileEstimator first(false, 3, 16);
+  ProfileEstimator second(false, 3, 16);
+  ProfileEstimator empty(false, 3, 16);
+  first.Accept(mat);
+  second.Accept(mat);
+  second.Accept(mat);
+  EXPECT_FALSE(first.HasBestEstimate());
+  EXPECT_FALSE(second.HasBestEstimate());
+
+  // Merging an estimator without frames keeps the votes
+  empty.Merge(first);
+  EXPECT_FALSE(empty.HasBestEstimate());
+
+  // Together they have, as if one estimator received all frames
+  empty.Merge(second);
+  EXPECT_TRUE(empty.HasBestEstimate());
+  EXPECT_EQ(empty.GetBestEstimateFrameSize(), std::make_pair(160, 120));
+}
+
+}  // namespace video_detect
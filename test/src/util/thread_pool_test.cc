@@ -0,0 +1,73 @@
+/**
+ * MIT License Copyright (c) 2021 CppEngineer
+ */
+
+#include "video-detect/util/thread_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <vector>
+
+#include "video-detect/mat/conv.h"
+#include "video-detect/mat/kernel_defs.h"
+#include "video-detect/mat/mat_2d.h"
+
+namespace video_detect {
+namespace util {
+
+TEST(UtilTests, ThreadPoolTestCoversRangeOnce) {
+  ThreadPool thread_pool(4);
+  std::vector<std::atomic<int>> counts(1000);
+  for (auto &count : counts) {
+    count = 0;
+  }
+
+  // Run a loop with a nested loop, which runs serially inside the band
+  thread_pool.ParallelFor(0, 1000, 7, [&](int begin, int end) {
+    thread_pool.ParallelFor(begin, end, 1, [&](int inner_begin, int inner_end) {
+      for (int i = inner_begin; i < inner_end; i++) {
+        ++counts[i];
+      }
+    });
+  });
+
+  // Test that every index was visited exactly once
+  EXPECT_EQ(thread_pool.GetThreadCount(), 4);
+  for (auto &count : counts) {
+    EXPECT_EQ(count, 1);
+  }
+}
+
+TEST(UtilTests, ThreadPoolTestMatrixOperationsMatchSerial) {
+  // Create a test matrix with pseudo random values
+  mat::Mat2D<float> mat(301, 45);
+  std::srand(9);
+  for (int row = 0; row < mat.GetRowCount(); row++) {
+    for (int col = 0; col < mat.GetColCount(); col++) {
+      mat.SetValue(row, col, static_cast<float>(std::rand() % 256));
+    }
+  }
+
+  // Calculate a convolution and an expression serially and in parallel
+  SetThreadCount(1);
+  mat::Mat2D<float> expected = mat::ConvMat2D(mat, mat::kKernelGaussian5x5);
+  mat::Mat2D<float> expected_sum = expected + mat;
+  SetThreadCount(4);
+  mat::Mat2D<float> result = mat::ConvMat2D(mat, mat::kKernelGaussian5x5);
+  mat::Mat2D<float> result_sum = result + mat;
+  SetThreadCount(1);
+
+  // Test that the results are identical
+  for (int row = 0; row < mat.GetRowCount(); row++) {
+    for (int col = 0; col < mat.GetColCount(); col++) {
+      EXPECT_EQ(result.GetValue(row, col), expected.GetValue(row, col));
+      EXPECT_EQ(result_sum.GetValue(row, col),
+                expected_sum.GetValue(row, col));
+    }
+  }
+}
+
+}  // namespace util
+}  // namespace video_detect